@@ -20,6 +20,8 @@
 // Tests and displays all ADC channel values and voltages
 // Includes BirdsBoard-style FIR filtering for comparison
 
+#include <Controls.h>
+
 // ADC pins
 #define PITCH_CV   26  // ADC0
 #define PITCH_KNOB 27  // ADC1
@@ -29,41 +31,16 @@
 // Gate input for reference
 #define GATE_IN    2   // GPIO2
 
-// ADC parameters
-const float ADC_VREF = 3.3;      // Reference voltage
-const int ADC_MAX_VALUE = 4095;  // 12-bit ADC (2^12 - 1)
-
-// ADC range calibration (from CLAUDE.md/BirdsBoard)
-#define PITCH_CV_MIN    0
-#define PITCH_CV_MAX    4095
-#define PITCH_KNOB_MIN  10
-#define PITCH_KNOB_MAX  4000
-#define CV1_MIN         8
-#define CV1_MAX         2000
-#define CV2_MIN         8
-#define CV2_MAX         2000
-
-// OpAmp scaling parameters (from BirdsBoard_Test)
-// Formula: ADC_voltage = CV_input × 0.33 + 1.65
-const float OPAMP_GAIN = 0.33;
-const float OPAMP_OFFSET = 1.65;
+// ADC reference, range calibration and OpAmp scaling
+// (ADC_voltage = CV_input × 0.33 + 1.65) come from Controls.h
 
 // Averaging parameters
 const int SAMPLES = 16;  // Number of samples to average
 uint32_t adcSum[4] = {0, 0, 0, 0};
 uint16_t sampleCount = 0;
 
-// Simple but effective ADC Filter
-struct ADCFilter {
-  uint16_t filtered;   // Current filtered value (integer for stability)
-  uint16_t lastOutput; // Last output value
-  uint32_t accumulator; // Running sum for averaging
-  uint8_t sampleCount; // Number of samples in accumulator
-  uint16_t deadband;   // Deadband threshold
-};
-
-ADCFilter adcFilters[4];
-const uint8_t AVG_SAMPLES = 16;  // Number of samples to average
+// Simple but effective ADC Filter (shared with Wren)
+AveragingADCFilter adcFilters[4];
 const uint16_t DEADBAND_THRESHOLD = 3;  // Ignore changes smaller than this
 
 void setup() {
@@ -175,12 +152,12 @@ void displayResults(uint16_t rawValues[], uint16_t filteredValues[], uint16_t av
     float adcVoltage = (float)filteredValues[i] / ADC_MAX_VALUE * ADC_VREF;
     
     // Calculate estimated CV input (reverse OpAmp scaling)
-    float cvInput = (adcVoltage - OPAMP_OFFSET) / OPAMP_GAIN;
+    float cvInput = (adcVoltage - CV_INPUT_OFFSET) / CV_INPUT_GAIN;
     
     // Handle inverted scaling for PITCH_CV (from BirdsBoard_Test)
     if (i == 0) { // PITCH_CV
       adcVoltage = ((ADC_MAX_VALUE - filteredValues[i]) / (float)ADC_MAX_VALUE) * ADC_VREF;
-      cvInput = (adcVoltage - OPAMP_OFFSET) / OPAMP_GAIN;
+      cvInput = (adcVoltage - CV_INPUT_OFFSET) / CV_INPUT_GAIN;
     }
     
     // Constrain CV input to reasonable range
@@ -250,16 +227,10 @@ void displayResults(uint16_t rawValues[], uint16_t filteredValues[], uint16_t av
 
 void displayCalculations(uint16_t adcValues[]) {
   // Calculate frequency from pitch CV (like BirdsBoard_Test)
-  float adcVoltage = ((ADC_MAX_VALUE - adcValues[0]) / (float)ADC_MAX_VALUE) * ADC_VREF;
-  float knobVoltage = (adcValues[1] / (float)ADC_MAX_VALUE) * ADC_VREF;
+  float cvOctaves = pitchCvVolts(adcValues[0]);
+  float knobOctaves = pitchKnobOctaves(adcValues[1]);
   
-  float actualCV = (adcVoltage - OPAMP_OFFSET) / OPAMP_GAIN;
-  actualCV = constrain(actualCV, 0.0, 5.0);
-  
-  float cvOctaves = actualCV;
-  float knobOctaves = (knobVoltage - OPAMP_OFFSET) / OPAMP_OFFSET;
-  
-  float frequency = 440.0 * pow(2.0, cvOctaves + knobOctaves - 4.0);
+  float frequency = octavesToFrequency(cvOctaves + knobOctaves - 4.0f);
   frequency = constrain(frequency, 20.0, 8000.0);
   
   Serial.print("Calculated Frequency: ");
@@ -289,42 +260,14 @@ void initializeADCFilters() {
   };
   
   for (int i = 0; i < 4; i++) {
-    adcFilters[i].filtered = 0;
-    adcFilters[i].lastOutput = 0;
-    adcFilters[i].accumulator = 0;
-    adcFilters[i].sampleCount = 0;
-    adcFilters[i].deadband = deadbands[i];
+    adcFilters[i].begin(deadbands[i]);
   }
 }
 
 void filterADCValues(uint16_t rawValues[4]) {
   for (int i = 0; i < 4; i++) {
-    // Simple running average
-    adcFilters[i].accumulator += rawValues[i];
-    adcFilters[i].sampleCount++;
-    
-    // Calculate average when we have enough samples
-    if (adcFilters[i].sampleCount >= AVG_SAMPLES) {
-      uint16_t avgValue = adcFilters[i].accumulator / AVG_SAMPLES;
-      
-      // Apply deadband - only update if change is significant
-      if (adcFilters[i].filtered == 0) {
-        // Initialize
-        adcFilters[i].filtered = avgValue;
-        adcFilters[i].lastOutput = avgValue;
-      } else {
-        int change = abs((int)avgValue - (int)adcFilters[i].lastOutput);
-        if (change > adcFilters[i].deadband) {
-          adcFilters[i].filtered = avgValue;
-          adcFilters[i].lastOutput = avgValue;
-        }
-        // If within deadband, keep the last output value
-      }
-      
-      // Reset accumulator
-      adcFilters[i].accumulator = 0;
-      adcFilters[i].sampleCount = 0;
-    }
+    // Simple running average with a deadband on the averaged value
+    adcFilters[i].process(rawValues[i]);
   }
 }
 
@@ -343,7 +286,7 @@ void displayFilterStatus() {
     Serial.print(", Samples: ");
     Serial.print(adcFilters[i].sampleCount);
     Serial.print("/");
-    Serial.println(AVG_SAMPLES);
+    Serial.println(ADC_AVERAGE_SAMPLES);
   }
   Serial.println();
 }
\ No newline at end of file
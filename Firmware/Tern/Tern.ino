@@ -17,6 +17,12 @@
  */
 
 #include <I2S.h>
+#include <AudioOutput.h>
+#include <FixedPoint.h>
+#include <Controls.h>
+#include <GateCapture.h>
+#include <Telemetry.h>
+#include <pico/multicore.h>
 
 // PT8211S I2S pins
 #define I2S_BCLK  6   // Bit clock
@@ -34,8 +40,32 @@
 // Create I2S instance for PT8211S
 I2S i2s(OUTPUT, I2S_BCLK, I2S_DOUT);
 
+// DMA double-buffered output, rendered in blocks of AUDIO_BUFFER_FRAMES
+#define AUDIO_BUFFER_FRAMES 64
+AudioOutput audioOutput(i2s);
+
+// DSP arithmetic: 1 = Q8.24 integer clock accumulator, 0 = float
+#define FIXED_POINT_DSP 0
+
+// Most LFSR clocks one sample can owe (under 256 for Q8.24); sets the
+// top of the clock range
+#define LFSR_MAX_CLOCKS_PER_SAMPLE 32
+
+// Output bits: 1 = the LSB as a square wave, up to 8 = the low bits of
+// the register as a signed multi-bit sample
+#define LFSR_OUTPUT_BITS 1
+
+// 1 = stream render cycles per sample, control latency and I2S underruns
+// over USB serial from core1 (Telemetry.h frames) instead of the text
+// debug line
+#define TELEMETRY 0
+
+#if TELEMETRY
+Telemetry<1> telemetry;
+#endif
+
 const int sampleRate = 44100;
-float frequency = 440.0;
+float frequency = 440.0f;
 const int amplitude = 12000;
 
 // LFSR parameters
@@ -44,9 +74,24 @@ uint8_t registerLength = 16;  // Number of bits to use (8-32)
 uint8_t tapPosition = 0;      // Tap position for feedback
 uint32_t registerMask = 0xFFFF; // Mask for register length
 
+// Step plan for the current tap and length, set in updateRegisterMask().
+// Each new bit is the tap bit XOR the MSB. The first tap + 1 new bits
+// only depend on bits already in the register, so that many clocks are
+// computed in one word operation.
+uint8_t stepChunk = 1;        // Clocks per word step
+uint8_t msbShift = 15;        // Aligns a chunk's MSB bits with its tap bits at bit 0
+uint32_t chunkMask = 1;       // The chunk's new bits
+bool singularFeedback = false;  // Tap is the MSB: feedback is 0 and the register drains
+
 // Timing and gate
-float phaseAccumulator = 0.0;
-bool lastGateState = false;
+#if FIXED_POINT_DSP
+uint32_t clockPhase = 0;      // Q8.24: the integer part is the clocks owed
+uint32_t clockIncrement = 0;  // Clocks per sample, Q8.24
+#else
+float phaseAccumulator = 0.0f;
+float clocksPerSample = 0.0f;
+#endif
+GateCapture<> gateCapture;  // LFSR reset edges, timestamped by the GPIO interrupt
 uint32_t sampleCounter = 0;
 
 void setup() {
@@ -55,125 +100,225 @@ void setup() {
   // Initialize ADC
   analogReadResolution(12);
   
-  // Initialize Gate input
+  // Initialize Gate input - the interrupt runs on this core, next to the renderer
   pinMode(GATE_IN, INPUT);
+  gateCapture.begin(digitalRead(GATE_IN));
+  attachInterrupt(digitalPinToInterrupt(GATE_IN), onGateEdge, CHANGE);
   
-  i2s.setBitsPerSample(16);
-  i2s.setLSBJFormat();
+#if TELEMETRY
+  telemetry.begin();
+#endif
   
-  if (!i2s.begin(sampleRate)) {
+  if (!audioOutput.begin(sampleRate, AUDIO_BUFFER_FRAMES, renderAudio)) {
     Serial.println("Failed to initialize I2S!");
     while (1);
   }
   
   updateRegisterMask();
   Serial.println("Tern LFSR Oscillator - CV Controlled");
+  
+  // Serial output runs on core1 so USB never stalls the render
+  multicore_launch_core1(core1Task);
 }
 
 void loop() {
-  // Read CV inputs every 64 samples
-  if (sampleCounter % 64 == 0) {
-    updateParameters();
-  }
+  // Renders whenever a DMA buffer is free, returns immediately otherwise
+  audioOutput.update();
+}
+
+// GPIO interrupt on both gate edges: level and time only, no DSP
+void onGateEdge() {
+  gateCapture.recordEdge(digitalRead(GATE_IN), micros());
+}
+
+// AudioOutput render callback - one DMA buffer of mono samples
+void renderAudio(int16_t* out, size_t frames) {
+#if TELEMETRY
+  uint32_t startCycles = cycleCount();
+#endif
   
-  // Generate LFSR sample at the specified frequency
-  phaseAccumulator += frequency / sampleRate;
+  // Reset edges that fall in this buffer on the sample clock, at their offsets
+  gateCapture.beginBlock(audioOutput.getBlockMicros(), frames, sampleRate);
+  int resetOffset;
+  bool resetPending = gateCapture.nextRisingEdge(resetOffset);
   
-  if (phaseAccumulator >= 1.0) {
-    phaseAccumulator -= 1.0;
+  for (size_t i = 0; i < frames; i++) {
+    // Read CV inputs every 64 samples
+    if (sampleCounter % 64 == 0) {
+#if TELEMETRY
+      uint32_t controlStart = cycleCount();
+      updateParameters();
+      telemetry.recordControlLatency(cycleCount() - controlStart);
+#else
+      updateParameters();
+#endif
+    }
+    
+    // Handle gate input - reset LFSR on the rising edge's sample
+    while (resetPending && resetOffset <= (int)i) {
+      lfsrState = 0xACE1u & registerMask; // Reset to initial seed (bit 0 set, never zero)
+      resetPending = gateCapture.nextRisingEdge(resetOffset);
+    }
+    
+#if FIXED_POINT_DSP
+    // Every clock owed this sample, at any clock rate
+    clockPhase += clockIncrement;
+    uint32_t clocks = clockPhase >> 24;
+    clockPhase &= 0xFFFFFF;
+#else
+    // Generate LFSR sample at the specified frequency
+    phaseAccumulator += clocksPerSample;
+    uint32_t clocks = (uint32_t)phaseAccumulator;
+    phaseAccumulator -= (float)clocks;
+#endif
+    if (clocks) {
+      clockLFSR(clocks);
+    }
+    
+    out[i] = lfsrSample();
     
-    // Clock the LFSR
-    clockLFSR();
+    sampleCounter++;
   }
   
-  // Convert LFSR output to audio sample
-  // Use the LSB of the LFSR as the output bit
-  float sampleFloat = (lfsrState & 1) ? 1.0 : -1.0;
-  int16_t sample = (int16_t)(sampleFloat * amplitude);
-  
-  // Write same sample to both channels
-  i2s.write(sample);
-  i2s.write(sample);
-  
-  sampleCounter++;
+#if TELEMETRY
+  telemetry.recordBlock(0, cycleCount() - startCycles, frames);
+#endif
 }
 
-void clockLFSR() {
-  // Get the feedback bit from the tap position
-  uint8_t actualTapPos = tapPosition % registerLength;
-  uint8_t feedbackBit = (lfsrState >> actualTapPos) & 1;
-  
-  // XOR with the MSB (for 1-tap LFSR)
-  uint8_t msbPos = registerLength - 1;
-  uint8_t msbBit = (lfsrState >> msbPos) & 1;
-  uint8_t newBit = feedbackBit ^ msbBit;
+#if LFSR_OUTPUT_BITS > 1
+// Low bits of the register as a signed sample
+int16_t lfsrSample() {
+  const uint32_t outputMask = (1UL << LFSR_OUTPUT_BITS) - 1;
+  int32_t level = (int32_t)(lfsrState & outputMask) * 2 - (int32_t)outputMask;
+  return (int16_t)(level * amplitude / (int32_t)outputMask);
+}
+#else
+// Use the LSB of the LFSR as the output bit
+int16_t lfsrSample() {
+  return (lfsrState & 1) ? amplitude : -amplitude;
+}
+#endif
+
+// Advance the register by `clocks` steps
+void clockLFSR(uint32_t clocks) {
+  uint32_t state = lfsrState;
   
-  // Shift left and insert new bit
-  lfsrState = ((lfsrState << 1) | newBit) & registerMask;
+  if (singularFeedback) {
+    // Shifts in zeros; the all-zero state restarts from 1 on the clock
+    // that reaches it
+    while (clocks--) {
+      state = (state << 1) & registerMask;
+      if (state == 0) {
+        state = 1;
+      }
+    }
+    lfsrState = state;
+    return;
+  }
   
-  // Prevent all-zero state
-  if (lfsrState == 0) {
-    lfsrState = 1;
+  // A non-singular register never reaches zero, so whole chunks of new
+  // bits (tap XOR MSB, oldest in the highest position) go in at once
+  while (clocks >= stepChunk) {
+    uint32_t newBits = (state ^ (state >> msbShift)) & chunkMask;
+    state = ((state << stepChunk) | newBits) & registerMask;
+    clocks -= stepChunk;
+  }
+  if (clocks) {
+    uint8_t offset = stepChunk - clocks;
+    uint32_t newBits = ((state >> offset) ^ (state >> (msbShift + offset))) & ((1UL << clocks) - 1);
+    state = ((state << clocks) | newBits) & registerMask;
   }
+  
+  lfsrState = state;
 }
 
 void updateParameters() {
-  // Read CV inputs and gate
+  // Read CV inputs
   uint16_t pitchCV = analogRead(PITCH_CV);
   uint16_t pitchKnob = analogRead(PITCH_KNOB);
   uint16_t cv1 = analogRead(CV1);
   uint16_t cv2 = analogRead(CV2);
-  bool gateState = digitalRead(GATE_IN);
+  // Calculate frequency with calibrated ranges (same as Wren)
+  float cvOctaves = pitchCvVolts(pitchCV);
+  float knobOctaves = pitchKnobOctaves(pitchKnob);
   
-  // Handle gate input - reset LFSR on rising edge
-  if (gateState && !lastGateState) {
-    lfsrState = 0xACE1u; // Reset to initial seed
-  }
-  lastGateState = gateState;
-  
-  // Calculate frequency (same as BirdsBoard_Test)
-  float adcVoltage = ((4095 - pitchCV) / 4095.0) * 3.3;
-  float knobVoltage = (pitchKnob / 4095.0) * 3.3;
-  
-  float actualCV = (adcVoltage - 1.65) / 0.33;
-  actualCV = constrain(actualCV, 0.0, 5.0);
+  frequency = octavesToFrequency(cvOctaves + knobOctaves - 4.0f);
+  frequency = constrain(frequency, 1.0f, (float)(sampleRate * LFSR_MAX_CLOCKS_PER_SAMPLE));
+#if FIXED_POINT_DSP
+  clockIncrement = (uint32_t)(frequency / sampleRate * 16777216.0f);
+#else
+  clocksPerSample = frequency / sampleRate;
+#endif
   
-  float cvOctaves = actualCV;
-  float knobOctaves = (knobVoltage - 1.65) / 1.65;
-  
-  frequency = 440.0 * pow(2.0, cvOctaves + knobOctaves - 4.0);
-  frequency = constrain(frequency, 1.0, 8000.0);
+  // CV2: Register length (1-32 bits)
+  uint8_t newRegisterLength = map(cv2, 0, 4095, 1, 32);
   
   // CV1: Tap position (0 to registerLength-1)
-  tapPosition = map(cv1, 0, 4095, 0, registerLength - 1);
+  uint8_t newTapPosition = map(cv1, 0, 4095, 0, newRegisterLength - 1);
   
-  // CV2: Register length (1-32 bits)
-  uint8_t newRegisterLength = map(cv2, 0, 4095, 1, 32);
-  if (newRegisterLength != registerLength) {
+  if (newRegisterLength != registerLength || newTapPosition != tapPosition) {
     registerLength = newRegisterLength;
+    tapPosition = newTapPosition;
     updateRegisterMask();
   }
+}
+
+// Core1: debug line once a second, or telemetry frames
+void core1Task() {
+#if TELEMETRY
+  uint32_t lastTelemetry = 0;
+#else
+  uint32_t lastPrint = 0;
+#endif
   
-  // Debug output
-  static uint32_t lastPrint = 0;
-  if (millis() - lastPrint > 1000) {
-    Serial.print("Freq: ");
-    Serial.print(frequency, 1);
-    Serial.print("Hz | RegLen: ");
-    Serial.print(registerLength);
-    Serial.print(" | Tap: ");
-    Serial.print(tapPosition);
-    Serial.print(" | LFSR: 0x");
-    Serial.print(lfsrState, HEX);
-    Serial.print(" | Gate: ");
-    Serial.print(gateState ? "HIGH" : "LOW");
-    Serial.println();
-    lastPrint = millis();
+  while (true) {
+    uint32_t now = millis();
+    
+#if TELEMETRY
+    // Skipped rather than waited for when the host isn't reading
+    if (now - lastTelemetry >= TELEMETRY_PERIOD_MS) {
+      uint8_t frame[telemetry.frameSize];
+      if (telemetry.poll(frame, audioOutput.getUnderruns(), sampleRate, rp2040.f_cpu())) {
+        lastTelemetry = now;
+        if (Serial.availableForWrite() >= (int)sizeof(frame)) {
+          Serial.write(frame, sizeof(frame));
+        }
+      }
+    }
+#else
+    // Read from the audio core's state; a value may be one update stale
+    if (now - lastPrint > 1000) {
+      Serial.print("Freq: ");
+      Serial.print(frequency, 1);
+      Serial.print("Hz | RegLen: ");
+      Serial.print(registerLength);
+      Serial.print(" | Tap: ");
+      Serial.print(tapPosition);
+      Serial.print(" | LFSR: 0x");
+      Serial.print(lfsrState, HEX);
+      Serial.print(" | Gate: ");
+      Serial.print(gateCapture.level() ? "HIGH" : "LOW");
+      Serial.println();
+      lastPrint = now;
+    }
+#endif
+    
+    delay(1);
   }
 }
 
 void updateRegisterMask() {
-  registerMask = (1UL << registerLength) - 1;
+  registerMask = (registerLength >= 32) ? 0xFFFFFFFFUL : (1UL << registerLength) - 1;
+  
+  uint8_t tap = tapPosition % registerLength;
+  uint8_t msb = registerLength - 1;
+  singularFeedback = (tap == msb);
+  if (!singularFeedback) {
+    stepChunk = tap + 1;
+    msbShift = msb - tap;
+    chunkMask = (1UL << stepChunk) - 1;
+  }
+  
   // Clamp LFSR state to new register length
   lfsrState &= registerMask;
   if (lfsrState == 0) {
@@ -0,0 +1,515 @@
+/**
+ * Tockus offline benchmark
+ *
+ * Renders each DrumAlgorithm through TockusDSP (and optionally PT8211DAC)
+ * as fast as possible, with no audio device and no Qt. Reports ns/sample,
+ * real-time factor and worst-case block time for the block and per-sample
+ * render paths, so DSP regressions show up before they reach the RP2350.
+ *
+ * Usage: tockus_bench [options]
+ *   --seconds N      Audio seconds rendered per algorithm and path (default 10)
+ *   --block N        Frames per block (default 64)
+ *   --retrigger MS   Gate period in milliseconds (default 250)
+ *   --algorithm N    Only run algorithm N (0-7)
+ *   --dac            Include PT8211DAC::processBlock in the timing
+ *   --wav DIR        Write each algorithm's block-path render to DIR
+ *   --csv FILE       Also write the results, with the block path's render
+ *                    profile (block p50/p99, DSP, algorithm and DAC cost,
+ *                    deadline misses), to FILE as CSV
+ *   --oversample     Compare the oversampled render (Oversampling.h) with
+ *                    the base-rate one instead: alias level on a naive
+ *                    square and the filters' cost, then the cost of ZAP,
+ *                    hi-hat and cowbell at 1x, 2x and 4x
+ *   --modes          Compare modal synthesis banks instead: a sinf per mode
+ *                    against ResonatorBank for 4, 8 and 16 modes, then the
+ *                    cost of MODAL hits at each mode count
+ */
+
+#include "tockus_dsp.h"
+#include "pt8211_dac.h"
+#include "wav_writer.h"
+#include "render_profiler.h"
+#include "Oversampling.h"
+#include "spectrum.h"
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const char* algorithmNames[NUM_ALGORITHMS] = {
+    "BASS", "SNARE", "HIHAT", "KARPLUS", "MODAL", "ZAP", "CLAP", "COWBELL"
+};
+
+static const int SAMPLE_RATE = TockusDSP::SAMPLE_RATE;
+static const float GATE_LENGTH_SECONDS = 0.01f;
+
+struct BenchOptions {
+    float seconds = 10.0f;
+    int blockSize = 64;
+    float retriggerMs = 250.0f;
+    int algorithm = -1;
+    bool useDAC = false;
+    const char* wavDir = nullptr;
+    const char* csvPath = nullptr;
+    bool oversample = false;
+    bool modes = false;
+};
+
+struct BenchResult {
+    double nsPerSample;
+    double realtimeFactor;
+    double worstBlockUs;
+};
+
+// CV1 value in the middle of an algorithm's slot
+static float algorithmCV(int algorithm) {
+    return std::min(1.0f, (algorithm + 0.5f) / (NUM_ALGORITHMS - 1));
+}
+
+static BenchResult runBench(int algorithm, bool perSample, const BenchOptions& options,
+                            std::vector<float>* capture, RenderProfiler* profiler) {
+    typedef std::chrono::steady_clock Clock;
+
+    TockusDSP dsp;
+    PT8211DAC dac;
+    dac.setSampleRate(SAMPLE_RATE);
+    dsp.setProfiler(profiler);
+
+    const float cv1 = algorithmCV(algorithm);
+    dsp.setParameters(0.5f, cv1, 0.5f, false);
+    if (dsp.getCurrentAlgorithm() != algorithm) {
+        fprintf(stderr, "warning: CV1 %.3f selected algorithm %d, expected %d\n",
+                cv1, dsp.getCurrentAlgorithm(), algorithm);
+    }
+
+    const uint64_t totalFrames = (uint64_t)(options.seconds * SAMPLE_RATE);
+    const uint64_t gatePeriod = std::max<uint64_t>(1, (uint64_t)(options.retriggerMs * 0.001f * SAMPLE_RATE));
+    const uint64_t gateLength = std::min<uint64_t>(gatePeriod / 2, (uint64_t)(GATE_LENGTH_SECONDS * SAMPLE_RATE));
+
+    std::vector<float> block(options.blockSize);
+    uint64_t nextGate = 0;
+    double worstBlockNs = 0.0;
+
+    Clock::time_point start = Clock::now();
+
+    for (uint64_t frame = 0; frame < totalFrames; frame += options.blockSize) {
+        int frames = (int)std::min<uint64_t>(options.blockSize, totalFrames - frame);
+        Clock::time_point blockStart = Clock::now();
+        Clock::time_point profileStart = profiler ? profiler->begin() : Clock::time_point();
+
+        // Schedule gate edges that fall inside this block, sample-accurately
+        while (nextGate < frame + frames) {
+            dsp.postParameters(0.5f, cv1, 0.5f, true, nextGate);
+            dsp.postParameters(0.5f, cv1, 0.5f, false, nextGate + std::max<uint64_t>(1, gateLength));
+            nextGate += gatePeriod;
+        }
+
+        if (perSample) {
+            for (int i = 0; i < frames; i++) {
+                block[i] = dsp.processNextSample();
+            }
+        } else {
+            dsp.processBlock(block.data(), frames);
+        }
+
+        if (options.useDAC) {
+            ProfileScope scope(profiler, PROFILE_DAC, frames);
+            dac.processBlock(block.data(), block.data(), frames);
+        }
+
+        if (profiler) {
+            profiler->end(PROFILE_CALLBACK, profileStart, frames);
+        }
+
+        double blockNs = std::chrono::duration<double, std::nano>(Clock::now() - blockStart).count();
+        worstBlockNs = std::max(worstBlockNs, blockNs);
+
+        if (capture) {
+            capture->insert(capture->end(), block.begin(), block.begin() + frames);
+        }
+    }
+
+    double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    BenchResult result;
+    result.nsPerSample = elapsedNs / totalFrames;
+    result.realtimeFactor = (totalFrames * 1e9 / SAMPLE_RATE) / elapsedNs;
+    result.worstBlockUs = worstBlockNs / 1000.0;
+    return result;
+}
+
+// --oversample ----------------------------------------------------------
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double elapsedNs(BenchClock::time_point start) {
+    return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+}
+
+// The engine's output lowpass (TockusEngine LOWPASS_ALPHA)
+struct OnePole {
+    float state = 0.0f;
+    float process(float x) {
+        state = 0.7f * x + 0.3f * state;
+        return state;
+    }
+};
+
+// Naive square (sign of a sine, as the hi-hat and cowbell oscillators)
+// at `frequency`, `factor` samples per output sample, decimated
+template <int Factor>
+static std::vector<float> renderSquare(double frequency, int frames) {
+    Decimator<float, Factor> decimator;
+    OnePole lowpass;
+    std::vector<float> out(frames);
+    float in[Factor];
+    for (int m = 0; m < frames; m++) {
+        for (int k = 0; k < Factor; k++) {
+            double phase = std::fmod(frequency * (m * Factor + k) / (SAMPLE_RATE * Factor), 1.0);
+            in[k] = phase < 0.5 ? 0.5f : -0.5f;
+        }
+        out[m] = lowpass.process(decimator.process(in));
+    }
+    return out;
+}
+
+// The square's harmonics below Nyquist only, summed directly
+static std::vector<float> renderBandlimitedSquare(double frequency, int frames) {
+    OnePole lowpass;
+    std::vector<float> out(frames);
+    for (int m = 0; m < frames; m++) {
+        double t = (double)m / SAMPLE_RATE;
+        double sum = 0.0;
+        for (int n = 1; n * frequency < SAMPLE_RATE / 2; n += 2) {
+            sum += std::sin(2.0 * M_PI * n * frequency * t) / n;
+        }
+        out[m] = lowpass.process((float)(sum * 2.0 / M_PI));
+    }
+    return out;
+}
+
+// Magnitude spectrum of the last 8192 samples, Hann windowed
+static std::vector<double> magnitudeSpectrum(const std::vector<float>& signal) {
+    const size_t n = 8192;
+    std::vector<std::complex<double>> x(n);
+    for (size_t i = 0; i < n; i++) {
+        x[i] = signal[signal.size() - n + i] * hannWindow(i, n);
+    }
+
+    fft(x);
+
+    std::vector<double> magnitude(n / 2);
+    for (size_t k = 0; k < n / 2; k++) {
+        magnitude[k] = std::abs(x[k]);
+    }
+    return magnitude;
+}
+
+// Everything in `signal` below 16kHz that the band-limited square lacks
+// (aliases, plus the filter's ripple), relative to the square, in dB
+static double aliasLevelDb(const std::vector<float>& signal, const std::vector<float>& ideal) {
+    std::vector<double> a = magnitudeSpectrum(signal);
+    std::vector<double> b = magnitudeSpectrum(ideal);
+    const size_t top = (size_t)(16000.0 * 8192 / SAMPLE_RATE);
+    double error = 0.0;
+    double energy = 0.0;
+    for (size_t k = 1; k < top; k++) {
+        error += (a[k] - b[k]) * (a[k] - b[k]);
+        energy += b[k] * b[k];
+    }
+    return 10.0 * std::log10(error / energy);
+}
+
+// ns per output sample of the output filtering alone
+template <typename T, int Factor>
+static double decimatorCost(int frames) {
+    Decimator<T, Factor> decimator;
+    std::vector<T> in((size_t)frames * Factor);
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = (T)((i * 2654435761u) >> 20);
+    }
+    volatile T sink = 0;
+    BenchClock::time_point start = BenchClock::now();
+    for (int m = 0; m < frames; m++) {
+        sink = decimator.process(&in[(size_t)m * Factor]);
+    }
+    (void)sink;
+    return elapsedNs(start) / frames;
+}
+
+static double onePoleCost(int frames) {
+    OnePole lowpass;
+    volatile float sink = 0.0f;
+    BenchClock::time_point start = BenchClock::now();
+    for (int m = 0; m < frames; m++) {
+        sink = lowpass.process((float)(m & 255));
+    }
+    (void)sink;
+    return elapsedNs(start) / frames;
+}
+
+template <int Factor>
+using OversampledEngine = TockusEngine<TOCKUS_SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE, TOCKUS_VOICES, false,
+                                       NullRenderProbe, OversampleAlgorithms<Factor, TOCKUS_ALIASING_ALGORITHMS>>;
+
+// ns per output sample for retriggered hits of one algorithm
+template <typename Engine>
+static double engineCost(int algorithm, const BenchOptions& options) {
+    static Engine engine;
+    engine.reset();
+    engine.setControls(Engine::scaleFrequency(440.0f, (uint8_t)algorithm), (uint8_t)algorithm, 0.5f);
+
+    const int totalFrames = (int)(options.seconds * SAMPLE_RATE);
+    const int gatePeriod = std::max(1, (int)(options.retriggerMs * 0.001f * SAMPLE_RATE));
+    std::vector<float> block(options.blockSize);
+
+    BenchClock::time_point start = BenchClock::now();
+    int nextGate = 0;
+    for (int frame = 0; frame < totalFrames; frame += options.blockSize) {
+        int frames = std::min(options.blockSize, totalFrames - frame);
+        if (frame >= nextGate) {
+            engine.trigger();
+            nextGate += gatePeriod;
+        }
+        engine.render(block.data(), frames);
+    }
+    return elapsedNs(start) / totalFrames;
+}
+
+static void runOversampleReport(const BenchOptions& options) {
+    const int frames = 16384;
+    const double squares[] = { 1234.5, 3456.7, 6789.1 };
+
+    printf("Alias level of a naive square below 16kHz, relative to the square (dB)\n\n");
+    printf("%-12s %14s %14s %14s\n", "square (Hz)", "1x one-pole", "2x half-band", "4x half-band");
+    for (double frequency : squares) {
+        std::vector<float> ideal = renderBandlimitedSquare(frequency, frames);
+        printf("%-12.1f %14.1f %14.1f %14.1f\n", frequency,
+               aliasLevelDb(renderSquare<1>(frequency, frames), ideal),
+               aliasLevelDb(renderSquare<2>(frequency, frames), ideal),
+               aliasLevelDb(renderSquare<4>(frequency, frames), ideal));
+    }
+
+    const int costFrames = std::max(SAMPLE_RATE, (int)(options.seconds * SAMPLE_RATE));
+    printf("\nOutput filtering cost (ns/sample at the output rate)\n\n");
+    printf("%-24s %10.2f\n", "one-pole (base rate)", onePoleCost(costFrames));
+    printf("%-24s %10.2f\n", "2x half-band, float", decimatorCost<float, 2>(costFrames));
+    printf("%-24s %10.2f\n", "4x half-band, float", decimatorCost<float, 4>(costFrames));
+    printf("%-24s %10.2f\n", "2x half-band, Q31", decimatorCost<int32_t, 2>(costFrames));
+    printf("%-24s %10.2f\n", "4x half-band, Q31", decimatorCost<int32_t, 4>(costFrames));
+
+    printf("\nEngine cost with the aliasing algorithms oversampled (ns/sample)\n\n");
+    printf("%-10s %10s %10s %10s\n", "algorithm", "1x", "2x", "4x");
+    const int algorithms[] = { ALGO_HIHAT, ALGO_ZAP, ALGO_COWBELL };
+    for (int algorithm : algorithms) {
+        if (options.algorithm >= 0 && algorithm != options.algorithm) {
+            continue;
+        }
+        printf("%-10s %10.1f %10.1f %10.1f\n", algorithmNames[algorithm],
+               engineCost<OversampledEngine<1>>(algorithm, options),
+               engineCost<OversampledEngine<2>>(algorithm, options),
+               engineCost<OversampledEngine<4>>(algorithm, options));
+    }
+}
+
+// --modes ---------------------------------------------------------------
+
+template <int Modes>
+using ModalEngine = TockusEngine<TOCKUS_SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE, TOCKUS_VOICES, false, NullRenderProbe,
+                                 NoOversampling, Modes>;
+
+// The modal loop before ResonatorBank: array-of-structs modes, a sinf and
+// an envelope per mode per sample
+struct SineMode {
+    float frequency;
+    float amplitude;
+    float phase;
+    DecayEnvelope envelope;
+};
+
+template <int Modes>
+static double sineModesCost(int frames) {
+    const float period = 1.0f / SAMPLE_RATE;
+    SineMode modes[Modes];
+    for (int i = 0; i < Modes; i++) {
+        modes[i].frequency = 220.0f * (1.0f + 0.55f * i);
+        modes[i].amplitude = 1.0f / (1 + i);
+        modes[i].phase = 0.0f;
+        modes[i].envelope.trigger(2.0f + i, period);
+    }
+
+    volatile float sink = 0.0f;
+    BenchClock::time_point start = BenchClock::now();
+    for (int m = 0; m < frames; m++) {
+        float output = 0.0f;
+        for (int i = 0; i < Modes; i++) {
+            output += sinf(modes[i].phase) * modes[i].amplitude * modes[i].envelope.process();
+            modes[i].phase += 6.28318531f * modes[i].frequency * period;
+            if (modes[i].phase >= 6.28318531f) {
+                modes[i].phase -= 6.28318531f;
+            }
+        }
+        sink = output;
+    }
+    (void)sink;
+    return elapsedNs(start) / frames;
+}
+
+template <int Modes>
+static double resonatorCost(int frames) {
+    const float period = 1.0f / SAMPLE_RATE;
+    ResonatorBank<Modes> bank;
+    for (int i = 0; i < Modes; i++) {
+        bank.start(i, 1.0f / (1 + i), expf(-(2.0f + i) * period));
+        bank.tune(i, 220.0f * (1.0f + 0.55f * i) * period);
+    }
+
+    volatile float sink = 0.0f;
+    BenchClock::time_point start = BenchClock::now();
+    for (int m = 0; m < frames; m++) {
+        sink = bank.processSine();
+    }
+    (void)sink;
+    return elapsedNs(start) / frames;
+}
+
+static void runModesReport(const BenchOptions& options) {
+    const int costFrames = std::max(SAMPLE_RATE, (int)(options.seconds * SAMPLE_RATE));
+    printf("Modal oscillator cost (ns/sample, one voice)\n\n");
+    printf("%-6s %14s %16s\n", "modes", "sinf per mode", "ResonatorBank");
+    printf("%-6d %14.2f %16.2f\n", 4, sineModesCost<4>(costFrames), resonatorCost<4>(costFrames));
+    printf("%-6d %14.2f %16.2f\n", 8, sineModesCost<8>(costFrames), resonatorCost<8>(costFrames));
+    printf("%-6d %14.2f %16.2f\n", 16, sineModesCost<16>(costFrames), resonatorCost<16>(costFrames));
+
+    printf("\nEngine cost of MODAL hits (ns/sample)\n\n");
+    printf("%-10s %10s %10s %10s\n", "algorithm", "4 modes", "8 modes", "16 modes");
+    printf("%-10s %10.1f %10.1f %10.1f\n", algorithmNames[ALGO_MODAL],
+           engineCost<ModalEngine<4>>(ALGO_MODAL, options), engineCost<ModalEngine<8>>(ALGO_MODAL, options),
+           engineCost<ModalEngine<16>>(ALGO_MODAL, options));
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--seconds N] [--block N] [--retrigger MS] [--algorithm N] [--dac] [--wav DIR]\n"
+            "          [--csv FILE] [--oversample] [--modes]\n",
+            program);
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (!strcmp(arg, "--seconds") && hasValue) {
+            options.seconds = (float)atof(argv[++i]);
+        } else if (!strcmp(arg, "--block") && hasValue) {
+            options.blockSize = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--retrigger") && hasValue) {
+            options.retriggerMs = (float)atof(argv[++i]);
+        } else if (!strcmp(arg, "--algorithm") && hasValue) {
+            options.algorithm = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--dac")) {
+            options.useDAC = true;
+        } else if (!strcmp(arg, "--wav") && hasValue) {
+            options.wavDir = argv[++i];
+        } else if (!strcmp(arg, "--csv") && hasValue) {
+            options.csvPath = argv[++i];
+        } else if (!strcmp(arg, "--oversample")) {
+            options.oversample = true;
+        } else if (!strcmp(arg, "--modes")) {
+            options.modes = true;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.seconds <= 0.0f || options.blockSize <= 0 || options.retriggerMs <= 0.0f ||
+        options.algorithm >= NUM_ALGORITHMS) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.oversample) {
+        runOversampleReport(options);
+        return 0;
+    }
+
+    if (options.modes) {
+        runModesReport(options);
+        return 0;
+    }
+
+    FILE* csv = nullptr;
+    if (options.csvPath) {
+        csv = fopen(options.csvPath, "w");
+        if (!csv) {
+            fprintf(stderr, "Failed to open %s\n", options.csvPath);
+            return 1;
+        }
+        fprintf(csv, "algorithm,path,block_frames,ns_per_sample,realtime_factor,worst_block_us,"
+                     "block_p50_us,block_p99_us,dsp_ns_per_sample,algorithm_ns_per_sample,"
+                     "dac_ns_per_sample,deadline_misses\n");
+    }
+
+    const double blockBudgetUs = options.blockSize * 1e6 / SAMPLE_RATE;
+    printf("Tockus benchmark: %.1f s per run, %d-frame blocks (%.1f us budget), retrigger %.0f ms%s\n\n",
+           options.seconds, options.blockSize, blockBudgetUs, options.retriggerMs,
+           options.useDAC ? ", PT8211 DAC" : "");
+    printf("%-10s %-11s %10s %12s %17s\n", "algorithm", "path", "ns/sample", "x realtime", "worst block (us)");
+
+    for (int algorithm = 0; algorithm < NUM_ALGORITHMS; algorithm++) {
+        if (options.algorithm >= 0 && algorithm != options.algorithm) {
+            continue;
+        }
+
+        // Profiled only on the block path: per-sample probes would be
+        // most of what they measure
+        std::vector<float> capture;
+        RenderProfiler profiler;
+        profiler.setSampleRate(SAMPLE_RATE);
+        BenchResult block = runBench(algorithm, false, options, options.wavDir ? &capture : nullptr,
+                                     csv ? &profiler : nullptr);
+        BenchResult sample = runBench(algorithm, true, options, nullptr, nullptr);
+
+        printf("%-10s %-11s %10.1f %12.1f %17.2f\n", algorithmNames[algorithm], "block",
+               block.nsPerSample, block.realtimeFactor, block.worstBlockUs);
+        printf("%-10s %-11s %10.1f %12.1f %17.2f\n", "", "per-sample",
+               sample.nsPerSample, sample.realtimeFactor, sample.worstBlockUs);
+
+        if (csv) {
+            StageStats blocks = profiler.getStats(PROFILE_CALLBACK);
+            fprintf(csv, "%s,block,%d,%.2f,%.2f,%.3f,%.3f,%.3f,%.2f,%.2f,%.2f,%llu\n",
+                    algorithmNames[algorithm], options.blockSize,
+                    block.nsPerSample, block.realtimeFactor, block.worstBlockUs,
+                    blocks.percentileNs(0.5) / 1000.0, blocks.percentileNs(0.99) / 1000.0,
+                    profiler.getStats(PROFILE_DSP).nsPerSample(),
+                    profiler.getStats(PROFILE_ALGORITHM + algorithm).nsPerSample(),
+                    profiler.getStats(PROFILE_DAC).nsPerSample(),
+                    (unsigned long long)profiler.getDeadlineMisses());
+            fprintf(csv, "%s,per-sample,%d,%.2f,%.2f,%.3f,,,,,,\n",
+                    algorithmNames[algorithm], options.blockSize,
+                    sample.nsPerSample, sample.realtimeFactor, sample.worstBlockUs);
+        }
+
+        if (options.wavDir) {
+            std::string path = std::string(options.wavDir) + "/tockus_" + algorithmNames[algorithm] + ".wav";
+            if (!writeWavFile(path.c_str(), capture, SAMPLE_RATE)) {
+                fprintf(stderr, "Failed to write %s\n", path.c_str());
+                return 1;
+            }
+        }
+    }
+
+    if (csv) {
+        fclose(csv);
+    }
+
+    return 0;
+}
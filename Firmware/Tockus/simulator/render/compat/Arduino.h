@@ -0,0 +1,9 @@
+#ifndef TOCKUS_RENDER_ARDUINO_H
+#define TOCKUS_RENDER_ARDUINO_H
+
+// Just enough of the Arduino core for the sketch data headers that
+// tockus_render includes (Wren's waveforms.h): flash placement is a no-op
+// on the desktop.
+#define PROGMEM
+
+#endif // TOCKUS_RENDER_ARDUINO_H
@@ -0,0 +1,316 @@
+/**
+ * Tockus and Wren batch renderer
+ *
+ * Sweeps a parameter grid and writes one WAV per point, for sample packs
+ * and A/B listening, with no audio device and no Qt:
+ *
+ *   Tockus: every algorithm x pitch CV (0-5V) x CV2 step, one hit each through
+ *           TockusDSP and PT8211DAC
+ *   Wren:   every preset bank x modulation type x amount, through the
+ *           firmware's oscillator.h (WrenVoice)
+ *
+ * Renders are independent, so a pool of worker threads takes them from a
+ * shared counter. Each render gets its own TockusDSP and PT8211DAC with a
+ * fixed noise seed, so a file's contents never depend on the thread count
+ * or on which worker picked it up. index.csv in the output directory
+ * lists every file with its settings.
+ *
+ * Usage: tockus_render --out DIR [options]
+ *   --pitches N         Pitch CV steps from 0 to 5V (default 8)
+ *   --params N          CV2 steps from 0 to 1 (default 8)
+ *   --amounts N         Wren modulation amount steps from 0 to 1 (default 8)
+ *   --seconds S         Length of each render (default 1)
+ *   --wren-frequency HZ Wren oscillator pitch (default 220)
+ *   --tockus-only       Skip the Wren grid
+ *   --wren-only         Skip the Tockus grid
+ *   --no-dac            Write Tockus renders without the PT8211 model
+ *   --threads N         Worker threads (default: one per core)
+ */
+
+#include "tockus_dsp.h"
+#include "pt8211_dac.h"
+#include "wav_writer.h"
+#include "wren_voice.h"
+#include "waveforms.h"
+#include "Controls.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const char* algorithmNames[NUM_ALGORITHMS] = {
+    "BASS", "SNARE", "HIHAT", "KARPLUS", "MODAL", "ZAP", "CLAP", "COWBELL"
+};
+
+static const char* const modulationNames[NUM_MODULATION_TYPES] = {
+    "fold", "overflow", "bitcrush", "pd", "resonance"
+};
+
+static const int SAMPLE_RATE = TockusDSP::SAMPLE_RATE;
+static const int RENDER_BLOCK = 64;
+static const int WREN_CONTROL_PERIOD = 16;  // updateParameters() interval in Wren.ino
+static const int WREN_BANKS = 8;
+
+struct RenderOptions {
+    const char* outDir = nullptr;
+    int pitches = 8;
+    int params = 8;
+    int amounts = 8;
+    float seconds = 1.0f;
+    float wrenFrequency = 220.0f;
+    bool tockus = true;
+    bool wren = true;
+    bool useDAC = true;
+    int threads = 0;
+};
+
+// One point of the grid. Tockus: `index` is the algorithm, `a` the pitch
+// CV in volts and `b` CV2. Wren: `index` is the bank, `mode` the
+// modulation type and `a` the amount.
+struct RenderJob {
+    bool wren;
+    int index;
+    int mode;
+    float a;
+    float b;
+    uint32_t seed;
+    std::string file;
+};
+
+struct RenderResult {
+    bool ok = false;
+    float frequency = 0.0f;  // The voice's pitch
+};
+
+// Step `i` of `steps` evenly spaced values from 0 to 1; a single step sits
+// in the middle
+static float gridValue(int i, int steps) {
+    return steps > 1 ? (float)i / (steps - 1) : 0.5f;
+}
+
+// TockusDSP::setParameters() pitch (the ADC reading, 0-1) for a pitch CV
+// in volts: the inverse of pitchCvVolts() through the inverting input
+static float pitchForVolts(float volts) {
+    float adcVoltage = volts * CV_INPUT_GAIN + CV_INPUT_OFFSET;
+    float raw = PITCH_CV_MAX - adcVoltage / ADC_VREF * PITCH_CV_MAX;
+    return (raw - PITCH_CV_MIN + 0.5f) / (PITCH_CV_MAX - PITCH_CV_MIN);
+}
+
+// CV1 value in the middle of an algorithm's slot
+static float algorithmCV(int algorithm) {
+    return std::min(1.0f, (algorithm + 0.5f) / (NUM_ALGORITHMS - 1));
+}
+
+static std::vector<RenderJob> buildJobs(const RenderOptions& options) {
+    std::vector<RenderJob> jobs;
+    char name[96];
+
+    if (options.tockus) {
+        for (int algorithm = 0; algorithm < NUM_ALGORITHMS; algorithm++) {
+            for (int p = 0; p < options.pitches; p++) {
+                for (int c = 0; c < options.params; c++) {
+                    float volts = 5.0f * gridValue(p, options.pitches);
+                    float cv2 = gridValue(c, options.params);
+                    snprintf(name, sizeof(name), "tockus_%s_%.2fV_cv2_%03d.wav", algorithmNames[algorithm], volts,
+                             (int)(cv2 * 100.0f + 0.5f));
+                    jobs.push_back({ false, algorithm, 0, volts, cv2, (uint32_t)jobs.size() + 1, name });
+                }
+            }
+        }
+    }
+
+    if (options.wren) {
+        for (int bank = 0; bank < WREN_BANKS; bank++) {
+            for (int mode = 0; mode < NUM_MODULATION_TYPES; mode++) {
+                for (int s = 0; s < options.amounts; s++) {
+                    float amount = gridValue(s, options.amounts);
+                    snprintf(name, sizeof(name), "wren_%s_%s_amount%03d.wav", waveform_names[bank],
+                             modulationNames[mode], (int)(amount * 100.0f + 0.5f));
+                    jobs.push_back({ true, bank, mode, amount, 0.0f, (uint32_t)jobs.size() + 1, name });
+                }
+            }
+        }
+    }
+    return jobs;
+}
+
+// One hit from silence: select the algorithm, then raise the gate
+static RenderResult renderTockus(const RenderJob& job, const RenderOptions& options, std::vector<float>& samples) {
+    std::unique_ptr<TockusDSP> dsp(new TockusDSP());
+    PT8211DAC dac;
+    dac.setSampleRate(SAMPLE_RATE);
+    dac.setNoiseSeed(job.seed);
+
+    const float pitch = pitchForVolts(job.a);
+    const float cv1 = algorithmCV(job.index);
+    dsp->setParameters(pitch, cv1, job.b, false);
+    dsp->setParameters(pitch, cv1, job.b, true);
+
+    for (size_t frame = 0; frame < samples.size(); frame += RENDER_BLOCK) {
+        int frames = (int)std::min<size_t>(RENDER_BLOCK, samples.size() - frame);
+        dsp->processBlock(&samples[frame], frames);
+        if (options.useDAC) {
+            dac.processBlock(&samples[frame], &samples[frame], frames);
+        }
+    }
+
+    // The pitch CV with the knob at its centre detent, scaled and clamped
+    // for the algorithm as the engine does
+    typedef TockusEngine<TOCKUS_SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE> Engine;
+    RenderResult result;
+    result.ok = dsp->getCurrentAlgorithm() == job.index;
+    result.frequency = Engine::scaleFrequency(octavesToFrequency(job.a - 4.0f), (uint8_t)job.index);
+    if (!result.ok) {
+        fprintf(stderr, "%s: CV1 %.3f selected algorithm %d\n", job.file.c_str(), cv1, dsp->getCurrentAlgorithm());
+    }
+    return result;
+}
+
+// A held note at a fixed amount, at the firmware's control rate
+static RenderResult renderWren(const RenderJob& job, const RenderOptions& options, std::vector<float>& samples) {
+    WrenVoice<> voice;
+    voice.start(preset_waveforms[job.index], options.wrenFrequency, SAMPLE_RATE);
+
+    for (size_t n = 0; n < samples.size(); n++) {
+        if (n % WREN_CONTROL_PERIOD == 0) {
+            voice.setAmount(job.a);
+        }
+        samples[n] = voice.process((uint8_t)job.mode);
+    }
+
+    RenderResult result;
+    result.ok = true;
+    result.frequency = options.wrenFrequency;
+    return result;
+}
+
+static void runWorker(const std::vector<RenderJob>& jobs, std::vector<RenderResult>& results,
+                      std::atomic<size_t>& next, const RenderOptions& options) {
+    std::vector<float> samples((size_t)(options.seconds * SAMPLE_RATE));
+
+    for (size_t i = next.fetch_add(1); i < jobs.size(); i = next.fetch_add(1)) {
+        const RenderJob& job = jobs[i];
+        RenderResult result = job.wren ? renderWren(job, options, samples) : renderTockus(job, options, samples);
+
+        std::string path = std::string(options.outDir) + "/" + job.file;
+        if (!writeWavFile(path.c_str(), samples, SAMPLE_RATE)) {
+            fprintf(stderr, "Failed to write %s\n", path.c_str());
+            result.ok = false;
+        }
+        results[i] = result;
+    }
+}
+
+static bool writeIndex(const std::vector<RenderJob>& jobs, const std::vector<RenderResult>& results,
+                       const RenderOptions& options) {
+    std::string path = std::string(options.outDir) + "/index.csv";
+    FILE* csv = fopen(path.c_str(), "w");
+    if (!csv) {
+        fprintf(stderr, "Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    fprintf(csv, "file,engine,voice,pitch_cv_volts,cv2,modulation,amount,frequency_hz,dac\n");
+    for (size_t i = 0; i < jobs.size(); i++) {
+        const RenderJob& job = jobs[i];
+        if (job.wren) {
+            fprintf(csv, "%s,wren,%s,,,%s,%.3f,%.2f,0\n", job.file.c_str(), waveform_names[job.index],
+                    modulationNames[job.mode], job.a, results[i].frequency);
+        } else {
+            fprintf(csv, "%s,tockus,%s,%.2f,%.3f,,,%.2f,%d\n", job.file.c_str(), algorithmNames[job.index], job.a,
+                    job.b, results[i].frequency, options.useDAC ? 1 : 0);
+        }
+    }
+
+    bool ok = !ferror(csv);
+    fclose(csv);
+    return ok;
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s --out DIR [--pitches N] [--params N] [--amounts N] [--seconds S]\n"
+            "          [--wren-frequency HZ] [--tockus-only] [--wren-only] [--no-dac] [--threads N]\n",
+            program);
+}
+
+int main(int argc, char* argv[]) {
+    RenderOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (!strcmp(arg, "--out") && hasValue) {
+            options.outDir = argv[++i];
+        } else if (!strcmp(arg, "--pitches") && hasValue) {
+            options.pitches = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--params") && hasValue) {
+            options.params = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--amounts") && hasValue) {
+            options.amounts = atoi(argv[++i]);
+        } else if (!strcmp(arg, "--seconds") && hasValue) {
+            options.seconds = (float)atof(argv[++i]);
+        } else if (!strcmp(arg, "--wren-frequency") && hasValue) {
+            options.wrenFrequency = (float)atof(argv[++i]);
+        } else if (!strcmp(arg, "--tockus-only")) {
+            options.wren = false;
+        } else if (!strcmp(arg, "--wren-only")) {
+            options.tockus = false;
+        } else if (!strcmp(arg, "--no-dac")) {
+            options.useDAC = false;
+        } else if (!strcmp(arg, "--threads") && hasValue) {
+            options.threads = atoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!options.outDir || options.pitches < 1 || options.params < 1 || options.amounts < 1 ||
+        options.seconds <= 0.0f || options.wrenFrequency <= 0.0f || options.threads < 0 ||
+        (!options.tockus && !options.wren)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<RenderJob> jobs = buildJobs(options);
+    std::vector<RenderResult> results(jobs.size());
+
+    int threads = options.threads ? options.threads : (int)std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<int>(threads, (int)jobs.size());
+
+    printf("Rendering %zu files of %.2f s on %d threads into %s\n", jobs.size(), options.seconds, threads,
+           options.outDir);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back(runWorker, std::cref(jobs), std::ref(results), std::ref(next), std::cref(options));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t failed = 0;
+    for (const RenderResult& result : results) {
+        failed += result.ok ? 0 : 1;
+    }
+    bool indexed = writeIndex(jobs, results, options);
+
+    double audioSeconds = jobs.size() * options.seconds;
+    printf("Done in %.2f s: %.0f renders/s, %.0fx realtime%s\n", seconds, jobs.size() / seconds,
+           audioSeconds / seconds, failed ? "" : ", all written");
+    if (failed) {
+        fprintf(stderr, "%zu renders failed\n", failed);
+    }
+    return (failed || !indexed) ? 1 : 0;
+}
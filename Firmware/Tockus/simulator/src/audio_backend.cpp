@@ -0,0 +1,89 @@
+#include "audio_backend.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef TOCKUS_HAVE_COREAUDIO
+#include "coreaudio_backend.h"
+#endif
+
+#ifdef TOCKUS_HAVE_PORTAUDIO
+#include "portaudio_backend.h"
+#endif
+
+std::vector<std::string> AudioBackend::availableBackends() {
+    std::vector<std::string> names;
+#ifdef TOCKUS_HAVE_COREAUDIO
+    names.push_back("CoreAudio");
+#endif
+#ifdef TOCKUS_HAVE_PORTAUDIO
+    names.push_back("PortAudio");
+#endif
+    return names;
+}
+
+std::unique_ptr<AudioBackend> AudioBackend::create(const std::string& name) {
+#ifdef TOCKUS_HAVE_COREAUDIO
+    if (name == "CoreAudio") {
+        return std::unique_ptr<AudioBackend>(new CoreAudioBackend());
+    }
+#endif
+#ifdef TOCKUS_HAVE_PORTAUDIO
+    if (name == "PortAudio") {
+        return std::unique_ptr<AudioBackend>(new PortAudioBackend());
+    }
+#endif
+#if !defined(TOCKUS_HAVE_COREAUDIO) && !defined(TOCKUS_HAVE_PORTAUDIO)
+    (void)name;  // No backend compiled in
+#endif
+    return nullptr;
+}
+
+void AudioBackend::prepare(const AudioConfig& newConfig, RenderCallback newRender) {
+    config = newConfig;
+    render = newRender;
+    lastError.clear();
+
+    // Allocated here, never on the audio thread
+    monoBuffer.assign(std::max(1, config.bufferFrames), 0.0f);
+}
+
+void AudioBackend::renderInterleaved(float* out, int frames, int channels) {
+    ProfileScope scope(profiler, PROFILE_CALLBACK, frames);
+    const int chunkFrames = (int)monoBuffer.size();
+
+    for (int start = 0; start < frames; start += chunkFrames) {
+        int chunk = std::min(chunkFrames, frames - start);
+
+        if (render) {
+            render(monoBuffer.data(), chunk);
+        } else {
+            std::fill(monoBuffer.begin(), monoBuffer.begin() + chunk, 0.0f);
+        }
+
+        float* dest = out + start * channels;
+        for (int i = 0; i < chunk; i++) {
+            for (int c = 0; c < channels; c++) {
+                dest[i * channels + c] = monoBuffer[i];
+            }
+        }
+    }
+}
+
+void AudioBackend::renderPlanar(float* const* out, int buffers, int frames) {
+    ProfileScope scope(profiler, PROFILE_CALLBACK, frames);
+    const int chunkFrames = (int)monoBuffer.size();
+
+    for (int start = 0; start < frames; start += chunkFrames) {
+        int chunk = std::min(chunkFrames, frames - start);
+
+        if (render) {
+            render(monoBuffer.data(), chunk);
+        } else {
+            std::fill(monoBuffer.begin(), monoBuffer.begin() + chunk, 0.0f);
+        }
+
+        for (int b = 0; b < buffers; b++) {
+            memcpy(out[b] + start, monoBuffer.data(), chunk * sizeof(float));
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef AUDIO_BACKEND_H
+#define AUDIO_BACKEND_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "render_profiler.h"
+
+/**
+ * Audio output backend interface
+ *
+ * A backend owns the device and its real-time thread and pulls audio from
+ * a block-render callback. The callback fills mono float frames; the
+ * backend copies them to every output channel. No Qt dependency, so the
+ * same backends serve the GUI and the headless tools.
+ */
+
+// Requested stream settings. After start() the backend reports the values
+// the device actually accepted through getConfig().
+struct AudioConfig {
+    int sampleRate = 44100;
+    int bufferFrames = 512;
+    int channels = 2;
+};
+
+// Called on the audio thread: fill `out` with `frames` mono samples.
+// `frames` never exceeds AudioConfig::bufferFrames.
+typedef std::function<void(float* out, int frames)> RenderCallback;
+
+class AudioBackend {
+public:
+    virtual ~AudioBackend() {}
+
+    virtual const char* getName() const = 0;
+
+    virtual bool start(const AudioConfig& config, RenderCallback render) = 0;
+    virtual void stop() = 0;
+    virtual bool isActive() const = 0;
+
+    // Output latency reported by the device, including the buffer (seconds)
+    virtual double getOutputLatency() const = 0;
+
+    const AudioConfig& getConfig() const { return config; }
+
+    // Time every device callback into PROFILE_CALLBACK and count device
+    // underflows (nullptr = off). Set before start().
+    void setProfiler(RenderProfiler* newProfiler) { profiler = newProfiler; }
+    const std::string& getLastError() const { return lastError; }
+
+    // Backends compiled into this build, preferred first
+    static std::vector<std::string> availableBackends();
+
+    // Returns nullptr for an unknown or unavailable backend name
+    static std::unique_ptr<AudioBackend> create(const std::string& name);
+
+protected:
+    // Renders into the interleaved device buffer in chunks of at most
+    // config.bufferFrames, using the preallocated mono buffer
+    void renderInterleaved(float* out, int frames, int channels);
+    void renderPlanar(float* const* out, int buffers, int frames);
+    void prepare(const AudioConfig& newConfig, RenderCallback newRender);
+
+    AudioConfig config;
+    RenderCallback render;
+    std::vector<float> monoBuffer;
+    std::string lastError;
+    RenderProfiler* profiler = nullptr;
+};
+
+#endif // AUDIO_BACKEND_H
@@ -0,0 +1,217 @@
+#include "coreaudio_backend.h"
+#include <algorithm>
+#include <cstdio>
+
+CoreAudioBackend::CoreAudioBackend()
+    : audioUnit(nullptr)
+    , audioActive(false)
+    , outputLatency(0.0)
+{
+}
+
+CoreAudioBackend::~CoreAudioBackend() {
+    stop();
+}
+
+bool CoreAudioBackend::setupAudioUnit() {
+    OSStatus status;
+
+    // Get default output device
+    AudioDeviceID deviceID;
+    UInt32 size = sizeof(AudioDeviceID);
+    AudioObjectPropertyAddress propertyAddress = {
+        kAudioHardwarePropertyDefaultOutputDevice,
+        kAudioObjectPropertyScopeGlobal,
+        kAudioObjectPropertyElementMain
+    };
+
+    status = AudioObjectGetPropertyData(kAudioObjectSystemObject,
+                                        &propertyAddress,
+                                        0, NULL,
+                                        &size, &deviceID);
+    if (status != noErr) {
+        lastError = "Failed to get default output device";
+        return false;
+    }
+
+    // Create audio component description
+    AudioComponentDescription desc;
+    desc.componentType = kAudioUnitType_Output;
+    desc.componentSubType = kAudioUnitSubType_DefaultOutput;
+    desc.componentManufacturer = kAudioUnitManufacturer_Apple;
+    desc.componentFlags = 0;
+    desc.componentFlagsMask = 0;
+
+    // Find audio component
+    AudioComponent component = AudioComponentFindNext(NULL, &desc);
+    if (component == NULL) {
+        lastError = "Failed to find audio component";
+        return false;
+    }
+
+    // Create audio unit
+    status = AudioComponentInstanceNew(component, &audioUnit);
+    if (status != noErr) {
+        lastError = "Failed to create audio unit";
+        return false;
+    }
+
+    // Set audio format (interleaved float)
+    AudioStreamBasicDescription format;
+    format.mSampleRate = config.sampleRate;
+    format.mFormatID = kAudioFormatLinearPCM;
+    format.mFormatFlags = kAudioFormatFlagIsFloat | kAudioFormatFlagIsPacked;
+    format.mChannelsPerFrame = config.channels;
+    format.mFramesPerPacket = 1;
+    format.mBitsPerChannel = 32;
+    format.mBytesPerFrame = format.mChannelsPerFrame * sizeof(Float32);
+    format.mBytesPerPacket = format.mBytesPerFrame * format.mFramesPerPacket;
+
+    status = AudioUnitSetProperty(audioUnit,
+                                  kAudioUnitProperty_StreamFormat,
+                                  kAudioUnitScope_Input,
+                                  0,
+                                  &format,
+                                  sizeof(format));
+    if (status != noErr) {
+        lastError = "Failed to set audio format";
+        cleanupAudioUnit();
+        return false;
+    }
+
+    // Request the device buffer size, then read back what it accepted
+    UInt32 bufferFrames = config.bufferFrames;
+    AudioUnitSetProperty(audioUnit,
+                         kAudioDevicePropertyBufferFrameSize,
+                         kAudioUnitScope_Global,
+                         0,
+                         &bufferFrames,
+                         sizeof(bufferFrames));
+    size = sizeof(bufferFrames);
+    if (AudioUnitGetProperty(audioUnit,
+                             kAudioDevicePropertyBufferFrameSize,
+                             kAudioUnitScope_Global,
+                             0,
+                             &bufferFrames,
+                             &size) == noErr && bufferFrames > 0) {
+        config.bufferFrames = (int)bufferFrames;
+        monoBuffer.assign(config.bufferFrames, 0.0f);
+    }
+
+    // Set render callback
+    AURenderCallbackStruct callbackStruct;
+    callbackStruct.inputProc = audioCallback;
+    callbackStruct.inputProcRefCon = this;
+
+    status = AudioUnitSetProperty(audioUnit,
+                                  kAudioUnitProperty_SetRenderCallback,
+                                  kAudioUnitScope_Input,
+                                  0,
+                                  &callbackStruct,
+                                  sizeof(callbackStruct));
+    if (status != noErr) {
+        lastError = "Failed to set render callback";
+        cleanupAudioUnit();
+        return false;
+    }
+
+    // Initialize audio unit
+    status = AudioUnitInitialize(audioUnit);
+    if (status != noErr) {
+        lastError = "Failed to initialize audio unit";
+        cleanupAudioUnit();
+        return false;
+    }
+
+    outputLatency = queryOutputLatency(deviceID);
+    return true;
+}
+
+// Device latency + safety offset + one buffer, in seconds
+double CoreAudioBackend::queryOutputLatency(AudioDeviceID deviceID) {
+    UInt32 latencyFrames = 0;
+    UInt32 safetyFrames = 0;
+    UInt32 size = sizeof(UInt32);
+
+    AudioObjectPropertyAddress address = {
+        kAudioDevicePropertyLatency,
+        kAudioDevicePropertyScopeOutput,
+        kAudioObjectPropertyElementMain
+    };
+    AudioObjectGetPropertyData(deviceID, &address, 0, NULL, &size, &latencyFrames);
+
+    address.mSelector = kAudioDevicePropertySafetyOffset;
+    size = sizeof(UInt32);
+    AudioObjectGetPropertyData(deviceID, &address, 0, NULL, &size, &safetyFrames);
+
+    return (double)(latencyFrames + safetyFrames + config.bufferFrames) / config.sampleRate;
+}
+
+void CoreAudioBackend::cleanupAudioUnit() {
+    if (audioUnit) {
+        AudioUnitUninitialize(audioUnit);
+        AudioComponentInstanceDispose(audioUnit);
+        audioUnit = nullptr;
+    }
+}
+
+bool CoreAudioBackend::start(const AudioConfig& newConfig, RenderCallback newRender) {
+    if (audioActive) {
+        stop();
+    }
+
+    prepare(newConfig, newRender);
+
+    if (!setupAudioUnit()) {
+        return false;
+    }
+
+    OSStatus status = AudioOutputUnitStart(audioUnit);
+    if (status != noErr) {
+        lastError = "Failed to start audio output";
+        cleanupAudioUnit();
+        return false;
+    }
+
+    audioActive = true;
+    return true;
+}
+
+void CoreAudioBackend::stop() {
+    if (!audioActive) {
+        return;
+    }
+
+    if (audioUnit) {
+        AudioOutputUnitStop(audioUnit);
+    }
+
+    cleanupAudioUnit();
+    audioActive = false;
+}
+
+OSStatus CoreAudioBackend::audioCallback(void* inRefCon,
+                                         AudioUnitRenderActionFlags* ioActionFlags,
+                                         const AudioTimeStamp* inTimeStamp,
+                                         UInt32 inBusNumber,
+                                         UInt32 inNumberFrames,
+                                         AudioBufferList* ioData) {
+    CoreAudioBackend* backend = static_cast<CoreAudioBackend*>(inRefCon);
+
+    if (ioData->mNumberBuffers > 1) {
+        // Separate buffer per channel
+        float* channels[16];
+        int buffers = std::min<int>(ioData->mNumberBuffers, 16);
+        for (int b = 0; b < buffers; b++) {
+            channels[b] = static_cast<Float32*>(ioData->mBuffers[b].mData);
+        }
+        backend->renderPlanar(channels, buffers, (int)inNumberFrames);
+    } else {
+        // Interleaved (or mono) single buffer
+        backend->renderInterleaved(static_cast<Float32*>(ioData->mBuffers[0].mData),
+                                   (int)inNumberFrames,
+                                   (int)ioData->mBuffers[0].mNumberChannels);
+    }
+
+    return noErr;
+}
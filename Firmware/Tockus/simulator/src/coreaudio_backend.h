@@ -0,0 +1,43 @@
+#ifndef COREAUDIO_BACKEND_H
+#define COREAUDIO_BACKEND_H
+
+#include "audio_backend.h"
+#include <AudioToolbox/AudioToolbox.h>
+#include <CoreAudio/CoreAudio.h>
+
+/**
+ * CoreAudio output backend (macOS)
+ *
+ * Default output AudioUnit with the device buffer size set from
+ * AudioConfig::bufferFrames.
+ */
+class CoreAudioBackend : public AudioBackend {
+public:
+    CoreAudioBackend();
+    ~CoreAudioBackend() override;
+
+    const char* getName() const override { return "CoreAudio"; }
+
+    bool start(const AudioConfig& config, RenderCallback render) override;
+    void stop() override;
+    bool isActive() const override { return audioActive; }
+    double getOutputLatency() const override { return outputLatency; }
+
+private:
+    static OSStatus audioCallback(void* inRefCon,
+                                  AudioUnitRenderActionFlags* ioActionFlags,
+                                  const AudioTimeStamp* inTimeStamp,
+                                  UInt32 inBusNumber,
+                                  UInt32 inNumberFrames,
+                                  AudioBufferList* ioData);
+
+    bool setupAudioUnit();
+    void cleanupAudioUnit();
+    double queryOutputLatency(AudioDeviceID deviceID);
+
+    AudioUnit audioUnit;
+    bool audioActive;
+    double outputLatency;
+};
+
+#endif // COREAUDIO_BACKEND_H
@@ -1,13 +1,16 @@
 #include "mainwindow.h"
 #include "tockus_dsp.h"
 #include "pt8211_dac.h"
-#include "coreaudio_engine.h"
+#include "audio_backend.h"
+#include "render_profiler.h"
 #include <QMenuBar>
 #include <QStatusBar>
 #include <QMessageBox>
 #include <QApplication>
 #include <QDebug>
 #include <QKeyEvent>
+#include <algorithm>
+#include <cmath>
 
 // Algorithm names for the combo box
 const QStringList MainWindow::algorithmNames = {
@@ -37,7 +40,7 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , tockusDSP(nullptr)
     , pt8211DAC(nullptr)
-    , coreAudioEngine(nullptr)
+    , renderProfiler(nullptr)
     , centralWidget(nullptr)
     , mainLayout(nullptr)
     , gateState(false)
@@ -45,14 +48,18 @@ MainWindow::MainWindow(QWidget *parent)
     , currentPitchKnob(2000)
     , currentCV1(1000)
     , currentCV2(1000)
+    , testToneActive(false)
+    , testTonePhase(0.0f)
+    , lastCallbackNs(0)
+    , lastCallbackFrames(0)
+    , lastDspNs(0)
+    , lastDacNs(0)
 {
     // Create core components
     tockusDSP = new TockusDSP();
     pt8211DAC = new PT8211DAC();
-    coreAudioEngine = new CoreAudioEngine(this);
-    
-    // Initialize audio engine
-    coreAudioEngine->initialize(tockusDSP, pt8211DAC);
+    renderProfiler = new RenderProfiler();
+    tockusDSP->setProfiler(renderProfiler);
     
     // Setup UI
     setupUI();
@@ -74,13 +81,11 @@ MainWindow::MainWindow(QWidget *parent)
 }
 
 MainWindow::~MainWindow() {
-    if (coreAudioEngine) {
-        coreAudioEngine->stopAudio();
-    }
+    stopAudio();
     
     delete tockusDSP;
     delete pt8211DAC;
-    // coreAudioEngine is QObject child, will be deleted automatically
+    delete renderProfiler;
 }
 
 void MainWindow::setupUI() {
@@ -233,24 +238,38 @@ void MainWindow::setupAudioGroup() {
     audioGroup = new QGroupBox("Audio & DAC Status", this);
     QVBoxLayout* audioLayout = new QVBoxLayout(audioGroup);
     
-    // Create a simple horizontal layout for CoreAudio buttons
+    // Backend / buffer size selection and start buttons
     QHBoxLayout* buttonLayout = new QHBoxLayout();
     
-    // CoreAudio buttons only
-    coreAudioButton = new QPushButton("Start CoreAudio", this);
-    coreAudioButton->setMinimumHeight(50);
-    coreAudioButton->setMinimumWidth(150);
-    coreAudioButton->setStyleSheet("font-weight: bold; font-size: 14px; background-color: #000066; color: white;");
-    coreAudioButton->setEnabled(true);  // Explicitly enable
-    
-    coreAudioTestButton = new QPushButton("CoreAudio Test 440Hz", this);
-    coreAudioTestButton->setMinimumHeight(50);
-    coreAudioTestButton->setMinimumWidth(150);
-    coreAudioTestButton->setStyleSheet("font-weight: bold; font-size: 14px; background-color: #006600; color: white;");
-    coreAudioTestButton->setEnabled(true);  // Explicitly enable
+    backendCombo = new QComboBox(this);
+    for (const std::string& name : AudioBackend::availableBackends()) {
+        backendCombo->addItem(QString::fromStdString(name));
+    }
     
-    buttonLayout->addWidget(coreAudioButton);
-    buttonLayout->addWidget(coreAudioTestButton);
+    bufferSizeCombo = new QComboBox(this);
+    for (int frames : {32, 64, 128, 256, 512, 1024}) {
+        bufferSizeCombo->addItem(QString("%1 frames").arg(frames), frames);
+    }
+    bufferSizeCombo->setCurrentIndex(bufferSizeCombo->findData(512));
+    
+    audioButton = new QPushButton("Start Audio", this);
+    audioButton->setMinimumHeight(50);
+    audioButton->setMinimumWidth(150);
+    audioButton->setStyleSheet("font-weight: bold; font-size: 14px; background-color: #000066; color: white;");
+    audioButton->setEnabled(backendCombo->count() > 0);
+    
+    testToneButton = new QPushButton("Test 440Hz", this);
+    testToneButton->setMinimumHeight(50);
+    testToneButton->setMinimumWidth(150);
+    testToneButton->setStyleSheet("font-weight: bold; font-size: 14px; background-color: #006600; color: white;");
+    testToneButton->setEnabled(backendCombo->count() > 0);
+    
+    buttonLayout->addWidget(new QLabel("Backend:", this));
+    buttonLayout->addWidget(backendCombo);
+    buttonLayout->addWidget(new QLabel("Buffer:", this));
+    buttonLayout->addWidget(bufferSizeCombo);
+    buttonLayout->addWidget(audioButton);
+    buttonLayout->addWidget(testToneButton);
     
     audioLayout->addLayout(buttonLayout);
     
@@ -272,10 +291,28 @@ void MainWindow::setupAudioGroup() {
     
     audioLayout->addLayout(dacLayout);
     
+    // DSP load: callback render time over the buffer period
+    QHBoxLayout* loadLayout = new QHBoxLayout();
+    
+    dspLoadLabel = new QLabel("DSP Load:", this);
+    dspLoadDisplay = new QProgressBar(this);
+    dspLoadDisplay->setRange(0, 100);
+    dspLoadDisplay->setValue(0);
+    dspLoadDisplay->setFormat("%p%");
+    
+    dspDetailLabel = new QLabel("Audio stopped", this);
+    dspDetailLabel->setStyleSheet("font-family: monospace;");
+    
+    loadLayout->addWidget(dspLoadLabel);
+    loadLayout->addWidget(dspLoadDisplay);
+    loadLayout->addWidget(dspDetailLabel);
+    
+    audioLayout->addLayout(loadLayout);
+    
     mainLayout->addWidget(audioGroup);
     
     // Add helpful text
-    QLabel* instructionLabel = new QLabel("使い方: 1) Start CoreAudio ボタンを押す  2) TRIGGER ボタンまたはスペースキーでドラムを鳴らす  3) CV1でアルゴリズムを変更", this);
+    QLabel* instructionLabel = new QLabel("使い方: 1) Start Audio ボタンを押す  2) TRIGGER ボタンまたはスペースキーでドラムを鳴らす  3) CV1でアルゴリズムを変更", this);
     instructionLabel->setWordWrap(true);
     instructionLabel->setStyleSheet("color: #666; font-size: 11px; margin: 5px;");
     audioLayout->addWidget(instructionLabel);
@@ -297,29 +334,21 @@ void MainWindow::setupMenuBar() {
     // Audio menu for testing
     QMenu* audioMenu = menuBar->addMenu("&Audio");
     
-    QAction* coreAudioTestAction = audioMenu->addAction("CoreAudio Test (440Hz)");
-    connect(coreAudioTestAction, &QAction::triggered, [this]() {
-        if (coreAudioEngine) {
-            coreAudioEngine->startTestTone();
-            statusBar()->showMessage("CoreAudio test tone started - You should hear 440Hz");
-        }
+    QAction* testToneAction = audioMenu->addAction("Test Tone (440Hz)");
+    connect(testToneAction, &QAction::triggered, [this]() {
+        startAudio(true);
     });
     
-    QAction* stopCoreAudioAction = audioMenu->addAction("Stop CoreAudio Test");
-    connect(stopCoreAudioAction, &QAction::triggered, [this]() {
-        if (coreAudioEngine) {
-            coreAudioEngine->stopTestTone();
-            statusBar()->showMessage("CoreAudio test stopped");
-        }
+    QAction* startAudioAction = audioMenu->addAction("Start Tockus");
+    connect(startAudioAction, &QAction::triggered, [this]() {
+        startAudio(false);
     });
     
     audioMenu->addSeparator();
     
-    QAction* startCoreAudioAction = audioMenu->addAction("Start CoreAudio Tockus");
-    connect(startCoreAudioAction, &QAction::triggered, [this]() {
-        if (coreAudioEngine) {
-            coreAudioEngine->startAudio();
-        }
+    QAction* stopAudioAction = audioMenu->addAction("Stop Audio");
+    connect(stopAudioAction, &QAction::triggered, [this]() {
+        stopAudio();
     });
     
     // Help menu
@@ -356,37 +385,141 @@ void MainWindow::connectSignals() {
             this, &MainWindow::onAlgorithmChanged);
     
     
-    // CoreAudio engine connections
-    connect(coreAudioButton, &QPushButton::clicked, [this]() {
-        if (coreAudioEngine->isAudioActive()) {
-            coreAudioEngine->stopAudio();
+    // Audio output connections
+    connect(audioButton, &QPushButton::clicked, [this]() {
+        if (audioBackend && audioBackend->isActive() && !testToneActive) {
+            stopAudio();
         } else {
-            coreAudioEngine->startAudio();
+            startAudio(false);
         }
     });
     
-    connect(coreAudioTestButton, &QPushButton::clicked, [this]() {
-        if (coreAudioEngine) {
-            coreAudioEngine->startTestTone();
+    connect(testToneButton, &QPushButton::clicked, [this]() {
+        if (audioBackend && audioBackend->isActive() && testToneActive) {
+            stopAudio();
+        } else {
+            startAudio(true);
         }
     });
     
-    connect(coreAudioEngine, &CoreAudioEngine::audioStarted, [this]() {
-        coreAudioButton->setText("Stop CoreAudio");
-        coreAudioButton->setStyleSheet("font-weight: bold; font-size: 12px; background-color: #CC0000;");
-        statusBar()->showMessage("CoreAudio active");
-    });
+    // Backend or buffer size change restarts a running stream
+    auto restartAudio = [this]() {
+        if (audioBackend && audioBackend->isActive()) {
+            startAudio(testToneActive);
+        }
+    };
+    connect(backendCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), restartAudio);
+    connect(bufferSizeCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), restartAudio);
+}
+
+bool MainWindow::startAudio(bool testTone) {
+    stopAudio();
     
-    connect(coreAudioEngine, &CoreAudioEngine::audioStopped, [this]() {
-        coreAudioButton->setText("CoreAudio");
-        coreAudioButton->setStyleSheet("font-weight: bold; font-size: 12px; background-color: #000066;");
-        statusBar()->showMessage("CoreAudio stopped");
-    });
+    audioBackend = AudioBackend::create(backendCombo->currentText().toStdString());
+    if (!audioBackend) {
+        statusBar()->showMessage("No audio backend available");
+        return false;
+    }
     
-    connect(coreAudioEngine, &CoreAudioEngine::audioError, [this](const QString& error) {
-        QMessageBox::critical(this, "CoreAudio Error", error);
-        statusBar()->showMessage("CoreAudio error: " + error);
-    });
+    AudioConfig config;
+    config.sampleRate = TockusDSP::SAMPLE_RATE;  // Fixed by the firmware engine
+    config.bufferFrames = bufferSizeCombo->currentData().toInt();
+    config.channels = 2;
+    
+    pt8211DAC->setSampleRate(config.sampleRate);
+    
+    // No render thread is running yet
+    renderProfiler->reset();
+    renderProfiler->setSampleRate(config.sampleRate);
+    lastCallbackNs = 0;
+    lastCallbackFrames = 0;
+    lastDspNs = 0;
+    lastDacNs = 0;
+    audioBackend->setProfiler(renderProfiler);
+    
+    testToneActive = testTone;
+    testTonePhase = 0.0f;
+    
+    RenderCallback render;
+    if (testTone) {
+        render = [this](float* out, int frames) { renderTestTone(out, frames); };
+    } else {
+        render = [this](float* out, int frames) { renderAudio(out, frames); };
+    }
+    
+    if (!audioBackend->start(config, render)) {
+        QString error = QString::fromStdString(audioBackend->getLastError());
+        audioBackend.reset();
+        QMessageBox::critical(this, "Audio Error", error);
+        statusBar()->showMessage("Audio error: " + error);
+        updateAudioControls();
+        return false;
+    }
+    
+    const AudioConfig& actual = audioBackend->getConfig();
+    statusBar()->showMessage(QString("%1 active - %2 frames @ %3 Hz, output latency %4 ms%5")
+        .arg(audioBackend->getName())
+        .arg(actual.bufferFrames)
+        .arg(actual.sampleRate)
+        .arg(audioBackend->getOutputLatency() * 1000.0, 0, 'f', 1)
+        .arg(testTone ? " (440Hz test tone)" : ""));
+    updateAudioControls();
+    return true;
+}
+
+void MainWindow::stopAudio() {
+    if (!audioBackend) {
+        return;
+    }
+    
+    audioBackend->stop();
+    audioBackend.reset();
+    testToneActive = false;
+    
+    if (statusBar()) {
+        statusBar()->showMessage("Audio stopped");
+    }
+    updateAudioControls();
+}
+
+void MainWindow::updateAudioControls() {
+    bool running = audioBackend && audioBackend->isActive();
+    
+    audioButton->setText(running && !testToneActive ? "Stop Audio" : "Start Audio");
+    audioButton->setStyleSheet(running && !testToneActive
+        ? "font-weight: bold; font-size: 14px; background-color: #CC0000; color: white;"
+        : "font-weight: bold; font-size: 14px; background-color: #000066; color: white;");
+    testToneButton->setText(running && testToneActive ? "Stop Test" : "Test 440Hz");
+}
+
+// Audio thread: Tockus voice through the PT8211 model
+void MainWindow::renderAudio(float* out, int frames) {
+    tockusDSP->processBlock(out, frames);
+    {
+        ProfileScope scope(renderProfiler, PROFILE_DAC, frames);
+        pt8211DAC->processBlock(out, out, frames);
+    }
+    
+    for (int i = 0; i < frames; i++) {
+        // Apply reduced gain to prevent clipping
+        float sample = out[i] * 0.1f;
+        
+        // Ensure sample is in valid range
+        out[i] = std::max(-1.0f, std::min(sample, 1.0f));
+    }
+}
+
+// Audio thread: 440Hz sine to check the output path
+void MainWindow::renderTestTone(float* out, int frames) {
+    const float phaseIncrement = 2.0f * (float)M_PI * 440.0f / 44100.0f;
+    
+    for (int i = 0; i < frames; i++) {
+        out[i] = std::sin(testTonePhase) * 0.1f;
+        testTonePhase += phaseIncrement;
+        if (testTonePhase >= 2.0f * (float)M_PI) {
+            testTonePhase -= 2.0f * (float)M_PI;
+        }
+    }
 }
 
 void MainWindow::onPitchCVChanged(int value) {
@@ -444,8 +577,15 @@ void MainWindow::updateParameters() {
     float cv1Norm = (float)(currentCV1 - CV1_MIN) / (CV1_MAX - CV1_MIN);
     float cv2Norm = (float)(currentCV2 - CV2_MIN) / (CV2_MAX - CV2_MIN);
     
-    // Update DSP parameters
-    tockusDSP->setParameters(pitchNorm, cv1Norm, cv2Norm, gateState);
+    // Update DSP parameters - hand off lock-free while the render thread
+    // owns the DSP, otherwise apply directly
+    if (audioBackend && audioBackend->isActive() && !testToneActive) {
+        if (!tockusDSP->postParameters(pitchNorm, cv1Norm, cv2Norm, gateState)) {
+            qDebug() << "Parameter queue full, event dropped";
+        }
+    } else {
+        tockusDSP->setParameters(pitchNorm, cv1Norm, cv2Norm, gateState);
+    }
 }
 
 void MainWindow::updateDisplay() {
@@ -477,6 +617,56 @@ void MainWindow::updateDisplay() {
     // Update DAC statistics
     dacTHDDisplay->display(pt8211DAC->getCurrentTHD() * 100.0); // Convert to percentage
     dacSNRDisplay->display(pt8211DAC->getCurrentSNR());
+    
+    updateLoadDisplay();
+}
+
+void MainWindow::updateLoadDisplay() {
+    if (!audioBackend || !audioBackend->isActive()) {
+        dspLoadDisplay->setValue(0);
+        dspDetailLabel->setText("Audio stopped");
+        return;
+    }
+    
+    StageStats callback = renderProfiler->getStats(PROFILE_CALLBACK);
+    StageStats dsp = renderProfiler->getStats(PROFILE_DSP);
+    StageStats dac = renderProfiler->getStats(PROFILE_DAC);
+    
+    uint64_t frames = callback.frames - lastCallbackFrames;
+    if (frames == 0) {
+        return;
+    }
+    
+    // Average load since the last update; the peak is the worst callback
+    double periodNs = frames * 1e9 / audioBackend->getConfig().sampleRate;
+    double load = (callback.totalNs - lastCallbackNs) / periodNs;
+    double dspLoad = (dsp.totalNs - lastDspNs) / periodNs;
+    double dacLoad = (dac.totalNs - lastDacNs) / periodNs;
+    float peakLoad = renderProfiler->takePeakLoad();
+    
+    lastCallbackNs = callback.totalNs;
+    lastCallbackFrames = callback.frames;
+    lastDspNs = dsp.totalNs;
+    lastDacNs = dac.totalNs;
+    
+    dspLoadDisplay->setValue(std::min(100, (int)(load * 100.0 + 0.5)));
+    dspDetailLabel->setText(QString("peak %1% | DSP %2% DAC %3% | p99 %4 us | late %5 underflow %6")
+        .arg(peakLoad * 100.0, 0, 'f', 1)
+        .arg(dspLoad * 100.0, 0, 'f', 1)
+        .arg(dacLoad * 100.0, 0, 'f', 1)
+        .arg(callback.percentileNs(0.99) / 1000.0, 0, 'f', 0)
+        .arg(renderProfiler->getDeadlineMisses())
+        .arg(renderProfiler->getUnderflows()));
+    
+    // Per-algorithm cost since audio started
+    QString breakdown = "Render time per output sample while sounding:";
+    for (int a = 0; a < NUM_ALGORITHMS; a++) {
+        StageStats stats = renderProfiler->getStats(PROFILE_ALGORITHM + a);
+        if (stats.count > 0) {
+            breakdown += QString("\n%1: %2 ns").arg(algorithmNames[a]).arg(stats.nsPerSample(), 0, 'f', 1);
+        }
+    }
+    dspLoadDisplay->setToolTip(breakdown);
 }
 
 void MainWindow::updateLEDDisplay() {
@@ -14,10 +14,12 @@
 #include <QComboBox>
 #include <QLCDNumber>
 #include <QFrame>
+#include <memory>
 
 class TockusDSP;
 class PT8211DAC;
-class CoreAudioEngine;
+class AudioBackend;
+class RenderProfiler;
 
 class MainWindow : public QMainWindow
 {
@@ -51,10 +53,19 @@ private:
     void updateParameters();
     void updateLEDDisplay();
     
+    // Audio output
+    bool startAudio(bool testTone);
+    void stopAudio();
+    void updateAudioControls();
+    void renderAudio(float* out, int frames);     // Audio thread
+    void renderTestTone(float* out, int frames);  // Audio thread
+    void updateLoadDisplay();
+    
     // Core components
     TockusDSP* tockusDSP;
     PT8211DAC* pt8211DAC;
-    CoreAudioEngine* coreAudioEngine;
+    std::unique_ptr<AudioBackend> audioBackend;
+    RenderProfiler* renderProfiler;
     
     // UI Components
     QWidget* centralWidget;
@@ -97,8 +108,13 @@ private:
     QLabel* dacSNRLabel;
     QLCDNumber* dacTHDDisplay;
     QLCDNumber* dacSNRDisplay;
-    QPushButton* coreAudioButton;
-    QPushButton* coreAudioTestButton;
+    QLabel* dspLoadLabel;
+    QProgressBar* dspLoadDisplay;
+    QLabel* dspDetailLabel;
+    QComboBox* backendCombo;
+    QComboBox* bufferSizeCombo;
+    QPushButton* audioButton;
+    QPushButton* testToneButton;
     
     // Update timer
     QTimer* updateTimer;
@@ -109,6 +125,14 @@ private:
     int currentPitchKnob;
     int currentCV1;
     int currentCV2;
+    bool testToneActive;
+    float testTonePhase;
+    
+    // Profiler totals at the previous display update
+    uint64_t lastCallbackNs;
+    uint64_t lastCallbackFrames;
+    uint64_t lastDspNs;
+    uint64_t lastDacNs;
     
     // Algorithm names
     static const QStringList algorithmNames;
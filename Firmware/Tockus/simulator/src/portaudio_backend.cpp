@@ -0,0 +1,88 @@
+#include "portaudio_backend.h"
+
+PortAudioBackend::PortAudioBackend()
+    : initialized(false)
+    , stream(nullptr)
+    , outputLatency(0.0)
+{
+    initialized = (Pa_Initialize() == paNoError);
+}
+
+PortAudioBackend::~PortAudioBackend() {
+    stop();
+    if (initialized) {
+        Pa_Terminate();
+    }
+}
+
+bool PortAudioBackend::start(const AudioConfig& newConfig, RenderCallback newRender) {
+    if (stream) {
+        stop();
+    }
+
+    prepare(newConfig, newRender);
+
+    if (!initialized) {
+        lastError = "PortAudio initialization failed";
+        return false;
+    }
+
+    PaStreamParameters output;
+    output.device = Pa_GetDefaultOutputDevice();
+    if (output.device == paNoDevice) {
+        lastError = "No default output device";
+        return false;
+    }
+
+    const PaDeviceInfo* device = Pa_GetDeviceInfo(output.device);
+    output.channelCount = config.channels;
+    output.sampleFormat = paFloat32;
+    output.suggestedLatency = device->defaultLowOutputLatency;
+    output.hostApiSpecificStreamInfo = nullptr;
+
+    PaError error = Pa_OpenStream(&stream, nullptr, &output, config.sampleRate,
+                                  config.bufferFrames, paClipOff, audioCallback, this);
+    if (error != paNoError) {
+        lastError = Pa_GetErrorText(error);
+        stream = nullptr;
+        return false;
+    }
+
+    error = Pa_StartStream(stream);
+    if (error != paNoError) {
+        lastError = Pa_GetErrorText(error);
+        Pa_CloseStream(stream);
+        stream = nullptr;
+        return false;
+    }
+
+    const PaStreamInfo* info = Pa_GetStreamInfo(stream);
+    outputLatency = info ? info->outputLatency : 0.0;
+    return true;
+}
+
+void PortAudioBackend::stop() {
+    if (!stream) {
+        return;
+    }
+
+    Pa_StopStream(stream);
+    Pa_CloseStream(stream);
+    stream = nullptr;
+}
+
+int PortAudioBackend::audioCallback(const void* input,
+                                    void* output,
+                                    unsigned long frameCount,
+                                    const PaStreamCallbackTimeInfo* timeInfo,
+                                    PaStreamCallbackFlags statusFlags,
+                                    void* userData) {
+    (void)input;  // Output-only stream
+    (void)timeInfo;
+    PortAudioBackend* backend = static_cast<PortAudioBackend*>(userData);
+    if ((statusFlags & paOutputUnderflow) && backend->profiler) {
+        backend->profiler->recordUnderflow();
+    }
+    backend->renderInterleaved(static_cast<float*>(output), (int)frameCount, backend->config.channels);
+    return paContinue;
+}
@@ -0,0 +1,38 @@
+#ifndef PORTAUDIO_BACKEND_H
+#define PORTAUDIO_BACKEND_H
+
+#include "audio_backend.h"
+#include <portaudio.h>
+
+/**
+ * PortAudio output backend (Linux ALSA/JACK, Windows, macOS)
+ *
+ * Opens the default output device with AudioConfig::bufferFrames per
+ * callback and the device's low-latency setting.
+ */
+class PortAudioBackend : public AudioBackend {
+public:
+    PortAudioBackend();
+    ~PortAudioBackend() override;
+
+    const char* getName() const override { return "PortAudio"; }
+
+    bool start(const AudioConfig& config, RenderCallback render) override;
+    void stop() override;
+    bool isActive() const override { return stream != nullptr; }
+    double getOutputLatency() const override { return outputLatency; }
+
+private:
+    static int audioCallback(const void* input,
+                             void* output,
+                             unsigned long frameCount,
+                             const PaStreamCallbackTimeInfo* timeInfo,
+                             PaStreamCallbackFlags statusFlags,
+                             void* userData);
+
+    bool initialized;
+    PaStream* stream;
+    double outputLatency;
+};
+
+#endif // PORTAUDIO_BACKEND_H
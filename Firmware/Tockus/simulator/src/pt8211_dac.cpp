@@ -2,6 +2,21 @@
 #include <cmath>
 #include <algorithm>
 
+// sin(2*pi*t) for t in [-0.5, 0.5]: parabola with one refinement step,
+// max error ~0.001 - plenty for a term scaled by THD * 0.1
+static inline float fastSinTurns(float t) {
+    float y = 8.0f * t - 16.0f * t * std::abs(t);
+    return y + 0.225f * (y * std::abs(y) - y);
+}
+
+// Uniform in [-1, 1)
+static inline float nextNoise(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (float)(int32_t)state * (1.0f / 2147483648.0f);
+}
+
 PT8211DAC::PT8211DAC() 
     : sampleRate(44100)
     , targetTHD(DEFAULT_THD)
@@ -9,21 +24,20 @@ PT8211DAC::PT8211DAC()
     , maxOutputVoltage(DEFAULT_MAX_OUTPUT)
     , currentTHD(0.0f)
     , currentSNR(0.0f)
-    , noiseGenerator(std::random_device{}())
-    , noiseDistribution(-1.0f, 1.0f)
-    , harmonicIndex(0)
+    , noiseState(0x2545F491u)
+    , oneFNoise(0.0f)
     , quantizationNoise(0.0f)
-    , lastQuantizedSample(0.0f)
+    , lowpassState(0.0f)
     , inputRMS(0.0f)
     , outputRMS(0.0f)
     , distortionRMS(0.0f)
     , noiseRMS(0.0f)
     , statisticsCounter(0)
 {
-    // Initialize harmonic buffer
-    for (int i = 0; i < 5; i++) {
-        harmonicBuffer[i] = 0.0f;
-    }
+    setSampleRate(sampleRate);
+    setTHD(targetTHD);
+    setSNR(targetSNR);
+    setMaxOutput(maxOutputVoltage);
 }
 
 PT8211DAC::~PT8211DAC() {
@@ -31,148 +45,127 @@ PT8211DAC::~PT8211DAC() {
 
 void PT8211DAC::setSampleRate(int sr) {
     sampleRate = sr;
+    
+    // Simple first-order lowpass at ~20kHz (well above audio range)
+    float cutoffFreq = 20000.0f;
+    lowpassAlpha = 1.0f / (1.0f + 2.0f * (float)M_PI * cutoffFreq / sampleRate);
 }
 
-float PT8211DAC::processSample(float inputSample) {
-    // Store original input for statistics
-    float originalInput = inputSample;
-    
-    // Step 1: Apply frequency response (minimal for PT8211 in audio range)
-    float processedSample = applyFrequencyResponse(inputSample);
-    
-    // Step 2: Apply quantization (16-bit R-2R ladder)
-    processedSample = applyQuantization(processedSample);
-    
-    // Step 3: Add harmonic distortion (THD simulation)
-    processedSample = addHarmonicDistortion(processedSample);
-    
-    // Step 4: Add thermal noise (SNR simulation)
-    processedSample = addThermalNoise(processedSample);
-    
-    // Step 5: Apply output voltage scaling (2.5V max)
-    processedSample = processedSample * (maxOutputVoltage / 2.5f);
-    
-    // Update statistics
-    updateStatistics(originalInput, processedSample);
-    
-    return processedSample;
+void PT8211DAC::setTHD(float thd) {
+    targetTHD = thd;
+    
+    // Second harmonic (most prominent in PT8211), third (less prominent),
+    // higher orders (very small)
+    secondHarmonicGain = 0.5f * thd * 2.0f;
+    thirdHarmonicGain = thd * 0.5f;
+    higherHarmonicGain = thd * 0.1f;
 }
 
-float PT8211DAC::applyQuantization(float sample) {
-    // Clamp to valid range
-    sample = std::max(-1.0f, std::min(sample, 1.0f));
-    
-    // Convert to 16-bit integer domain
-    int16_t quantized = (int16_t)(sample * MAX_DIGITAL_VALUE);
-    
-    // Add R-2R ladder quantization noise
-    // R-2R ladders have characteristic step-like quantization with slight non-linearity
-    float quantizationError = (float)quantized / MAX_DIGITAL_VALUE - sample;
-    
-    // R-2R ladder introduces correlated quantization noise
-    quantizationNoise = quantizationNoise * 0.95f + quantizationError * 0.05f;
-    
-    // Convert back to float with quantization applied
-    float quantizedSample = (float)quantized / MAX_DIGITAL_VALUE;
-    
-    // Add small amount of quantization noise correlation
-    quantizedSample += quantizationNoise * 0.1f;
-    
-    lastQuantizedSample = quantizedSample;
-    return quantizedSample;
+void PT8211DAC::setSNR(float snr) {
+    targetSNR = snr;
+    noiseScale = 1.0f / std::pow(10.0f, snr / 20.0f);
 }
 
-float PT8211DAC::addHarmonicDistortion(float sample) {
-    // Store sample in harmonic buffer
-    harmonicBuffer[harmonicIndex] = sample;
-    harmonicIndex = (harmonicIndex + 1) % 5;
-    
-    // Calculate harmonic content for THD
-    float fundamental = harmonicBuffer[0];  // Current sample as fundamental
-    float distortion = 0.0f;
-    
-    if (std::abs(fundamental) > 0.01f) {  // Only add distortion for significant signals
-        // Second harmonic (most prominent in PT8211)
-        float secondHarmonic = fundamental * fundamental * 0.5f;
-        distortion += secondHarmonic * targetTHD * 2.0f;
-        
-        // Third harmonic (less prominent)
-        float thirdHarmonic = fundamental * fundamental * fundamental;
-        distortion += thirdHarmonic * targetTHD * 0.5f;
-        
-        // Higher order harmonics (very small)
-        float higherHarmonics = std::sin(fundamental * 4.0f * M_PI) * targetTHD * 0.1f;
-        distortion += higherHarmonics;
-    }
-    
-    return sample + distortion;
+void PT8211DAC::setMaxOutput(float maxV) {
+    maxOutputVoltage = maxV;
+    outputGain = maxV / 2.5f;
 }
 
-float PT8211DAC::addThermalNoise(float sample) {
-    // Calculate noise level based on target SNR
-    float signalLevel = std::abs(sample);
-    float noiseLevel = signalLevel / std::pow(10.0f, targetSNR / 20.0f);
-    
-    // Generate thermal noise (Gaussian-like distribution)
-    float thermalNoise = noiseDistribution(noiseGenerator) * noiseLevel;
-    
-    // Add some 1/f noise characteristic of analog circuits
-    static float oneFNoise = 0.0f;
-    oneFNoise = oneFNoise * 0.999f + thermalNoise * 0.001f;
-    
-    // Combine thermal and 1/f noise
-    float totalNoise = thermalNoise * 0.8f + oneFNoise * 0.2f;
-    
-    return sample + totalNoise;
+void PT8211DAC::setNoiseSeed(uint32_t seed) {
+    // xorshift must not start at zero
+    noiseState = seed ? seed : 0x2545F491u;
 }
 
-float PT8211DAC::applyFrequencyResponse(float sample) {
-    // PT8211 has relatively flat frequency response in audio range
-    // Apply minimal high-frequency rolloff characteristic of R-2R DACs
-    
-    // Simple first-order lowpass at ~20kHz (well above audio range)
-    static float lastOutput = 0.0f;
-    float cutoffFreq = 20000.0f;  // 20kHz
-    float alpha = 1.0f / (1.0f + 2.0f * M_PI * cutoffFreq / sampleRate);
-    
-    float output = alpha * sample + (1.0f - alpha) * lastOutput;
-    lastOutput = output;
-    
+float PT8211DAC::processSample(float inputSample) {
+    float output;
+    processBlock(&inputSample, &output, 1);
     return output;
 }
 
-void PT8211DAC::updateStatistics(float input, float output) {
-    // Update running RMS values
-    inputRMS = inputRMS * 0.999f + (input * input) * 0.001f;
-    outputRMS = outputRMS * 0.999f + (output * output) * 0.001f;
+void PT8211DAC::processBlock(const float* in, float* out, int frames) {
+    // Work on local copies of the state so it stays in registers
+    float lowpass = lowpassState;
+    float quantNoise = quantizationNoise;
+    float oneF = oneFNoise;
+    uint32_t rng = noiseState;
+    float inRMS = inputRMS;
+    float outRMS = outputRMS;
+    float distRMS = distortionRMS;
+    
+    for (int i = 0; i < frames; i++) {
+        float input = in[i];
+        
+        // Step 1: Frequency response (minimal for PT8211 in audio range)
+        lowpass = lowpassAlpha * input + (1.0f - lowpassAlpha) * lowpass;
+        
+        // Step 2: Quantization (16-bit R-2R ladder)
+        float clamped = std::max(-1.0f, std::min(lowpass, 1.0f));
+        float quantized = (float)(int16_t)(clamped * MAX_DIGITAL_VALUE) * (1.0f / MAX_DIGITAL_VALUE);
+        
+        // R-2R ladders introduce correlated quantization noise
+        quantNoise = quantNoise * 0.95f + (quantized - clamped) * 0.05f;
+        float sample = quantized + quantNoise * 0.1f;
+        
+        // Step 3: Harmonic distortion, only for significant signals
+        float squared = sample * sample;
+        float turns = sample * 2.0f;  // sin(4*pi*x) = sin(2*pi * 2x)
+        turns -= std::floor(turns + 0.5f);
+        float distortion = squared * secondHarmonicGain
+                         + squared * sample * thirdHarmonicGain
+                         + fastSinTurns(turns) * higherHarmonicGain;
+        sample += std::abs(sample) > 0.01f ? distortion : 0.0f;
+        
+        // Step 4: Thermal noise (SNR) plus some 1/f noise of analog circuits
+        float thermalNoise = nextNoise(rng) * std::abs(sample) * noiseScale;
+        oneF = oneF * 0.999f + thermalNoise * 0.001f;
+        sample += thermalNoise * 0.8f + oneF * 0.2f;
+        
+        // Step 5: Output voltage scaling (2.5V max)
+        sample *= outputGain;
+        
+        // Running statistics
+        float error = sample - input;
+        inRMS = inRMS * 0.999f + (input * input) * 0.001f;
+        outRMS = outRMS * 0.999f + (sample * sample) * 0.001f;
+        distRMS = distRMS * 0.999f + (error * error) * 0.001f;
+        
+        out[i] = sample;
+    }
     
-    // Calculate distortion (difference between input and output)
-    float distortion = output - input;
-    distortionRMS = distortionRMS * 0.999f + (distortion * distortion) * 0.001f;
+    lowpassState = lowpass;
+    quantizationNoise = quantNoise;
+    oneFNoise = oneF;
+    noiseState = rng;
+    inputRMS = inRMS;
+    outputRMS = outRMS;
+    distortionRMS = distRMS;
     
     // Update statistics every so often
-    statisticsCounter++;
+    statisticsCounter += frames;
     if (statisticsCounter >= STATS_UPDATE_INTERVAL) {
         statisticsCounter = 0;
-        
-        // Calculate current THD
-        if (inputRMS > 0.0001f) {
-            currentTHD = std::sqrt(distortionRMS / inputRMS);
-        } else {
-            currentTHD = 0.0f;
-        }
-        
-        // Calculate current SNR
-        if (outputRMS > 0.0001f) {
-            float noiseLevel = std::sqrt(distortionRMS);
-            float signalLevel = std::sqrt(outputRMS);
-            currentSNR = 20.0f * std::log10(signalLevel / noiseLevel);
-        } else {
-            currentSNR = 0.0f;
-        }
-        
-        // Clamp to reasonable values
-        currentTHD = std::max(0.0f, std::min(currentTHD, 1.0f));
-        currentSNR = std::max(0.0f, std::min(currentSNR, 120.0f));
+        calculateStatistics();
     }
-}
\ No newline at end of file
+}
+
+void PT8211DAC::calculateStatistics() {
+    // Calculate current THD
+    if (inputRMS > 0.0001f) {
+        currentTHD = std::sqrt(distortionRMS / inputRMS);
+    } else {
+        currentTHD = 0.0f;
+    }
+    
+    // Calculate current SNR
+    if (outputRMS > 0.0001f) {
+        float noiseLevel = std::sqrt(distortionRMS);
+        float signalLevel = std::sqrt(outputRMS);
+        currentSNR = 20.0f * std::log10(signalLevel / noiseLevel);
+    } else {
+        currentSNR = 0.0f;
+    }
+    
+    // Clamp to reasonable values
+    currentTHD = std::max(0.0f, std::min(currentTHD, 1.0f));
+    currentSNR = std::max(0.0f, std::min(currentSNR, 120.0f));
+}
@@ -2,7 +2,6 @@
 #define PT8211_DAC_H
 
 #include <cstdint>
-#include <random>
 
 /**
  * PT8211 DAC Simulator
@@ -13,6 +12,9 @@
  * - 89-93dB SNR
  * - 2.5V maximum output
  * - Specific frequency response characteristics
+ *
+ * All filter and noise state lives in the instance, so several DACs can
+ * run side by side (one per thread or channel).
  */
 class PT8211DAC {
 public:
@@ -24,10 +26,14 @@ public:
     // Process a sample through the DAC simulation
     float processSample(float inputSample);
     
+    // Process a block; `in` and `out` may be the same buffer
+    void processBlock(const float* in, float* out, int frames);
+    
     // Configuration
-    void setTHD(float thd) { targetTHD = thd; }
-    void setSNR(float snr) { targetSNR = snr; }
-    void setMaxOutput(float maxV) { maxOutputVoltage = maxV; }
+    void setTHD(float thd);
+    void setSNR(float snr);
+    void setMaxOutput(float maxV);
+    void setNoiseSeed(uint32_t seed);
     
     // Statistics
     float getCurrentTHD() const { return currentTHD; }
@@ -36,7 +42,7 @@ public:
 private:
     // DAC specifications
     static constexpr int BIT_DEPTH = 16;
-    static constexpr int MAX_DIGITAL_VALUE = (1 << BIT_DEPTH) - 1;
+    static constexpr int MAX_DIGITAL_VALUE = (1 << (BIT_DEPTH - 1)) - 1;  // Signed full scale
     static constexpr float DEFAULT_THD = 0.0008f;  // 0.08%
     static constexpr float DEFAULT_SNR = 91.0f;    // 89-93dB (mid-range)
     static constexpr float DEFAULT_MAX_OUTPUT = 2.5f; // 2.5V
@@ -51,26 +57,27 @@ private:
     float currentTHD;
     float currentSNR;
     
-    // Noise generation
-    std::mt19937 noiseGenerator;
-    std::uniform_real_distribution<float> noiseDistribution;
+    // Coefficients derived from the settings (recomputed by the setters,
+    // never per sample)
+    float lowpassAlpha;       // 20kHz output rolloff
+    float noiseScale;         // 1 / 10^(SNR/20)
+    float secondHarmonicGain;
+    float thirdHarmonicGain;
+    float higherHarmonicGain;
+    float outputGain;         // maxOutputVoltage / 2.5V
     
-    // THD simulation (harmonic distortion)
-    float harmonicBuffer[5];  // Store last 5 samples for harmonic generation
-    int harmonicIndex;
+    // Noise generation (xorshift32)
+    uint32_t noiseState;
+    float oneFNoise;
     
     // R-2R ladder quantization simulation
     float quantizationNoise;
-    float lastQuantizedSample;
     
-    // Internal processing functions
-    float applyQuantization(float sample);
-    float addHarmonicDistortion(float sample);
-    float addThermalNoise(float sample);
-    float applyFrequencyResponse(float sample);
+    // Frequency response state
+    float lowpassState;
     
     // Statistics calculation
-    void updateStatistics(float input, float output);
+    void calculateStatistics();
     
     // Running statistics
     float inputRMS;
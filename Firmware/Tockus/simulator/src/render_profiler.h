@@ -0,0 +1,238 @@
+#ifndef RENDER_PROFILER_H
+#define RENDER_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "TockusEngine.h"
+
+/**
+ * Render-path profiler
+ *
+ * Times the audio callback, the DSP, the DAC model and each drum
+ * algorithm into lock-free histograms. The render thread is the only
+ * writer, so recording is a handful of relaxed loads and stores: no
+ * locks, no read-modify-write, no allocation. Any thread can read.
+ *
+ * Histogram buckets cover quarter-octaves of nanoseconds, so percentiles
+ * are accurate to within 19%.
+ */
+
+enum ProfileStage {
+    PROFILE_CALLBACK = 0,   // Whole device callback (or bench block)
+    PROFILE_DSP = 1,        // TockusDSP::processBlock
+    PROFILE_DAC = 2,        // PT8211DAC::processBlock
+    PROFILE_ALGORITHM = 3,  // + DrumAlgorithm: each algorithm's pass inside the engine
+    NUM_PROFILE_STAGES = PROFILE_ALGORITHM + NUM_ALGORITHMS
+};
+
+#define PROFILE_SUB_BUCKETS 4  // Buckets per octave
+#define PROFILE_BUCKETS 160    // Up to 2^40 ns
+
+// Copy of one stage's counters, taken by a reader
+struct StageStats {
+    uint64_t count;    // Recorded intervals
+    uint64_t totalNs;
+    uint64_t frames;   // Audio frames rendered in those intervals
+    uint64_t maxNs;
+    uint64_t buckets[PROFILE_BUCKETS];
+
+    double meanNs() const { return count ? (double)totalNs / count : 0.0; }
+    double nsPerSample() const { return frames ? (double)totalNs / frames : 0.0; }
+
+    // Upper bound of the bucket holding the p-th fraction (0-1) of intervals
+    double percentileNs(double p) const;
+};
+
+// Counters for one stage. Single writer; relaxed atomics so readers on
+// other threads never see torn values.
+struct StageHistogram {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalNs;
+    std::atomic<uint64_t> frames;
+    std::atomic<uint64_t> maxNs;
+    std::atomic<uint64_t> buckets[PROFILE_BUCKETS];
+
+    void reset() {
+        count.store(0, std::memory_order_relaxed);
+        totalNs.store(0, std::memory_order_relaxed);
+        frames.store(0, std::memory_order_relaxed);
+        maxNs.store(0, std::memory_order_relaxed);
+        for (int b = 0; b < PROFILE_BUCKETS; b++) {
+            buckets[b].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Writer only
+    void record(uint64_t ns, int frameCount) {
+        add(count, 1);
+        add(totalNs, ns);
+        add(frames, (uint64_t)frameCount);
+        if (ns > maxNs.load(std::memory_order_relaxed)) {
+            maxNs.store(ns, std::memory_order_relaxed);
+        }
+        add(buckets[bucketIndex(ns)], 1);
+    }
+
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // Octave of `ns` plus its next two bits
+    static int bucketIndex(uint64_t ns) {
+        if (ns < PROFILE_SUB_BUCKETS) {
+            return (int)ns;
+        }
+        int octave = 0;
+        while ((ns >> octave) >= 2 * PROFILE_SUB_BUCKETS) {
+            octave++;
+        }
+        int index = (octave + 1) * PROFILE_SUB_BUCKETS + (int)((ns >> octave) - PROFILE_SUB_BUCKETS);
+        return index < PROFILE_BUCKETS ? index : PROFILE_BUCKETS - 1;
+    }
+
+    static double bucketUpperNs(int index) {
+        if (index < PROFILE_SUB_BUCKETS) {
+            return index;
+        }
+        int octave = index / PROFILE_SUB_BUCKETS - 1;
+        int step = index % PROFILE_SUB_BUCKETS;
+        return (double)((uint64_t)(PROFILE_SUB_BUCKETS + step + 1) << octave) - 1.0;
+    }
+};
+
+inline double StageStats::percentileNs(double p) const {
+    uint64_t target = (uint64_t)(p * count + 0.5);
+    uint64_t seen = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= target && seen > 0) {
+            return StageHistogram::bucketUpperNs(b);
+        }
+    }
+    return (double)maxNs;
+}
+
+class RenderProfiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    RenderProfiler() : sampleRate(44100), enabled(true) { reset(); }
+
+    // Deadline for PROFILE_CALLBACK: frames / sampleRate
+    void setSampleRate(int rate) { sampleRate = rate; }
+
+    // Disabled: begin() returns a null time and nothing is recorded
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Clear every counter. Only while no render thread is recording.
+    void reset() {
+        for (int s = 0; s < NUM_PROFILE_STAGES; s++) {
+            stages[s].reset();
+        }
+        deadlineMisses.store(0, std::memory_order_relaxed);
+        underflows.store(0, std::memory_order_relaxed);
+        windowPeakLoad.store(0.0f, std::memory_order_relaxed);
+    }
+
+    // Writer side
+    Clock::time_point begin() const {
+        return isEnabled() ? Clock::now() : Clock::time_point();
+    }
+
+    void end(int stage, Clock::time_point start, int frames) {
+        if (start == Clock::time_point()) {
+            return;
+        }
+        uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        stages[stage].record(ns, frames);
+
+        if (stage == PROFILE_CALLBACK && frames > 0) {
+            // Share of the buffer period spent rendering it
+            float load = (float)((double)ns * sampleRate / (frames * 1e9));
+            if (load > windowPeakLoad.load(std::memory_order_relaxed)) {
+                windowPeakLoad.store(load, std::memory_order_relaxed);
+            }
+            if (load > 1.0f) {
+                StageHistogram::add(deadlineMisses, 1);
+            }
+        }
+    }
+
+    // Device-reported output underflow (backends that expose one)
+    void recordUnderflow() { StageHistogram::add(underflows, 1); }
+
+    // Reader side
+    StageStats getStats(int stage) const {
+        const StageHistogram& h = stages[stage];
+        StageStats stats;
+        stats.count = h.count.load(std::memory_order_relaxed);
+        stats.totalNs = h.totalNs.load(std::memory_order_relaxed);
+        stats.frames = h.frames.load(std::memory_order_relaxed);
+        stats.maxNs = h.maxNs.load(std::memory_order_relaxed);
+        for (int b = 0; b < PROFILE_BUCKETS; b++) {
+            stats.buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    uint64_t getDeadlineMisses() const { return deadlineMisses.load(std::memory_order_relaxed); }
+    uint64_t getUnderflows() const { return underflows.load(std::memory_order_relaxed); }
+
+    // Worst callback load since the last call, then restart the window.
+    // A callback racing the exchange may land in either window.
+    float takePeakLoad() { return windowPeakLoad.exchange(0.0f, std::memory_order_relaxed); }
+
+private:
+    int sampleRate;
+    std::atomic<bool> enabled;
+    StageHistogram stages[NUM_PROFILE_STAGES];
+    std::atomic<uint64_t> deadlineMisses;
+    std::atomic<uint64_t> underflows;
+    std::atomic<float> windowPeakLoad;
+};
+
+// Times the enclosing scope into one stage
+class ProfileScope {
+public:
+    ProfileScope(RenderProfiler* profiler, int stage, int frames)
+        : profiler(profiler)
+        , stage(stage)
+        , frames(frames)
+        , start(profiler ? profiler->begin() : RenderProfiler::Clock::time_point())
+    {
+    }
+
+    ~ProfileScope() {
+        if (profiler) {
+            profiler->end(stage, start, frames);
+        }
+    }
+
+private:
+    RenderProfiler* profiler;
+    int stage;
+    int frames;
+    RenderProfiler::Clock::time_point start;
+};
+
+// TockusEngine probe (see NullRenderProbe): times each algorithm's pass
+struct AlgorithmProbe {
+    RenderProfiler* profiler = nullptr;
+    RenderProfiler::Clock::time_point start;
+
+    void algorithmStarted(uint8_t) {
+        if (profiler) {
+            start = profiler->begin();
+        }
+    }
+
+    void algorithmFinished(uint8_t algorithm, int frames) {
+        if (profiler) {
+            profiler->end(PROFILE_ALGORITHM + algorithm, start, frames);
+        }
+    }
+};
+
+#endif // RENDER_PROFILER_H
@@ -0,0 +1,65 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * Spectrum helpers for the tests and the bench
+ *
+ * A Hann window, an in-place radix-2 FFT and a single-frequency lock-in
+ * amplitude. Double precision throughout, so the measurement stays well
+ * below the float render under test.
+ */
+
+// Hann window sample `n` of a `frames`-long frame
+inline double hannWindow(size_t n, size_t frames) {
+    return 0.5 - 0.5 * std::cos(2.0 * M_PI * n / frames);
+}
+
+// In-place radix-2 FFT, size a power of two
+inline void fft(std::vector<std::complex<double>>& x) {
+    const size_t n = x.size();
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(x[i], x[j]);
+        }
+    }
+    for (size_t length = 2; length <= n; length <<= 1) {
+        std::complex<double> step = std::polar(1.0, -2.0 * M_PI / length);
+        for (size_t start = 0; start < n; start += length) {
+            std::complex<double> w = 1.0;
+            for (size_t k = 0; k < length / 2; k++) {
+                std::complex<double> even = x[start + k];
+                std::complex<double> odd = x[start + k + length / 2] * w;
+                x[start + k] = even + odd;
+                x[start + k + length / 2] = even - odd;
+                w *= step;
+            }
+        }
+    }
+}
+
+// Amplitude of the component at `cycles` per sample in `frames` samples
+// from `start`, Hann windowed
+template <typename T>
+inline double amplitudeAt(const std::vector<T>& x, size_t start, size_t frames, double cycles) {
+    std::complex<double> sum = 0.0;
+    double windowSum = 0.0;
+    for (size_t n = 0; n < frames; n++) {
+        double window = hannWindow(n, frames);
+        sum += (double)x[start + n] * window * std::polar(1.0, -2.0 * M_PI * cycles * n);
+        windowSum += window;
+    }
+    return 2.0 * std::abs(sum) / windowSum;
+}
+
+#endif // SPECTRUM_H
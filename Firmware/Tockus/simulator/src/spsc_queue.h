@@ -0,0 +1,52 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Single-producer/single-consumer lock-free ring buffer
+ *
+ * One thread pushes (GUI), one thread pops (audio render callback).
+ * No locks and no allocation, so the consumer never blocks on the producer.
+ * Capacity must be a power of two; one slot is kept empty.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side - returns false (and drops the item) when full
+    bool push(const T& item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) & (Capacity - 1);
+        if (next == headIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        items[tail] = item;
+        tailIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side - oldest item without removing it, or nullptr if empty
+    const T* peek() const {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &items[head];
+    }
+
+    // Consumer side - removes the item returned by peek()
+    void pop() {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        headIndex.store((head + 1) & (Capacity - 1), std::memory_order_release);
+    }
+
+private:
+    T items[Capacity];
+    alignas(64) std::atomic<size_t> headIndex{0};
+    alignas(64) std::atomic<size_t> tailIndex{0};
+};
+
+#endif // SPSC_QUEUE_H
@@ -1,169 +1,97 @@
 #ifndef TOCKUS_DSP_H
 #define TOCKUS_DSP_H
 
-#include <cmath>
 #include <cstdint>
-#include <algorithm>
+#include <atomic>
+#include "TockusEngine.h"
+#include "spsc_queue.h"
+#include "render_profiler.h"
 
-// Constants from Arduino code
-#define PI 3.14159265359
-#define KARPLUS_BUFFER_SIZE 200
-#define NUM_MODES 4
-#define NUM_ALGORITHMS 8
+// Oversampling factor for ZAP, hi-hat and cowbell: 1 (off, as the
+// firmware ships), 2 or 4. Set from CMake (TOCKUS_OVERSAMPLING).
+#ifndef TOCKUS_OVERSAMPLING
+#define TOCKUS_OVERSAMPLING 1
+#endif
 
-// ADC range calibration (from CLAUDE.md)
-#define PITCH_CV_MIN    0
-#define PITCH_CV_MAX    4095
-#define PITCH_KNOB_MIN  10
-#define PITCH_KNOB_MAX  4000
-#define CV1_MIN         8
-#define CV1_MAX         2000
-#define CV2_MIN         8
-#define CV2_MAX         2000
+// Modes a MODAL hit rings: 4 (as the firmware ships), 8 or 16. Set from
+// CMake (TOCKUS_MODAL_MODES).
+#ifndef TOCKUS_MODAL_MODES
+#define TOCKUS_MODAL_MODES 4
+#endif
+#define PARAMETER_QUEUE_SIZE 64
 
-// Drum algorithms (same as Arduino)
-enum DrumAlgorithm {
-    ALGO_BASS = 0,      // 808 Bass drum
-    ALGO_SNARE = 1,     // 808 Snare drum
-    ALGO_HIHAT = 2,     // 808 Hi-hat
-    ALGO_KARPLUS = 3,   // Karplus-Strong
-    ALGO_MODAL = 4,     // Modal synthesis
-    ALGO_ZAP = 5,       // ZAP sound
-    ALGO_CLAP = 6,      // 808 Clap
-    ALGO_COWBELL = 7,   // Cowbell (two sine oscillators)
-};
-
-// Bandpass filter state (from Arduino)
-struct BandpassFilter {
-    float x1, x2;  // Input delay line
-    float y1, y2;  // Output delay line
-    float a0, a1, a2, b1, b2;  // Filter coefficients
-};
-
-// Resonant filter state (from Arduino)
-struct ResonantFilter {
-    float x1, x2;  // Input delay line
-    float y1, y2;  // Output delay line
-    float cutoff;   // Current cutoff frequency
-    float resonance; // Q factor
-    float a0, a1, a2, b1, b2;  // Filter coefficients
-};
-
-// Modal synthesis mode (from Arduino)
-struct Mode {
-    float frequency;
-    float amplitude;
-    float decay;
-    float phase;
+// Parameter/gate snapshot handed from the control thread to the renderer
+struct ParameterEvent {
+    float pitch;
+    float cv1;
+    float cv2;
+    bool gate;
+    uint64_t sampleTime;  // Absolute render sample to apply at (0 = next block)
 };
 
+// Desktop front end for the firmware's TockusEngine (BirdsBoard library):
+// GUI-normalized controls, the event queue and thread-safe display state.
+// The drum DSP itself is the exact code the RP2350 runs, with the
+// firmware's voice count (TOCKUS_VOICES), so overlapping hits steal alike.
 class TockusDSP {
 public:
+    static const int SAMPLE_RATE = TOCKUS_SAMPLE_RATE;
+    
     TockusDSP();
     ~TockusDSP();
     
     // Main processing functions
-    void setSampleRate(int sampleRate);
+    void setTriggerClock(TriggerClock clock) { engine.setTriggerClock(clock); }
     void setParameters(float pitch, float cv1, float cv2, bool gate);
     void triggerDrum();
     float processNextSample();
     
-    // Getters for UI
-    uint8_t getCurrentAlgorithm() const { return currentAlgorithm; }
-    float getCurrentFrequency() const { return currentFrequency; }
-    bool isTriggerActive() const { return triggerActive; }
-    float getEnvelopeAmplitude() const { return envAmplitude; }
+    // Block rendering: fills `out` with `frames` mono samples at
+    // SAMPLE_RATE. Control-rate updates run once per TOCKUS_BLOCK_SIZE
+    // frames, as on the hardware.
+    void processBlock(float* out, int frames);
+    
+    // Thread-safe parameter hand-off for a control thread (e.g. the GUI)
+    // while another thread renders. Lock-free; processBlock drains pending
+    // events and splits the block at each event's sampleTime, so gates are
+    // sample-accurate. Returns false if the queue is full.
+    bool postParameters(float pitch, float cv1, float cv2, bool gate, uint64_t sampleTime = 0);
+    
+    // Getters for UI (safe from any thread, published by the renderer)
+    uint8_t getCurrentAlgorithm() const { return displayAlgorithm.load(std::memory_order_relaxed); }
+    float getCurrentFrequency() const { return displayFrequency.load(std::memory_order_relaxed); }
+    bool isTriggerActive() const { return getActiveVoiceCount() > 0; }
+    float getEnvelopeAmplitude() const { return displayAmplitude.load(std::memory_order_relaxed); }
+    int getActiveVoiceCount() const { return displayVoiceCount.load(std::memory_order_relaxed); }
+    uint64_t getSampleCount() const { return displaySampleCount.load(std::memory_order_relaxed); }
+    
+    // Record processBlock and each algorithm's pass into `profiler`
+    // (nullptr = off). Set while no thread is rendering.
+    void setProfiler(RenderProfiler* profiler);
     
 private:
-    // Audio parameters
-    int sampleRate;
-    const float MASTER_GAIN = 2.0f;
-    bool gateState;
-    bool lastGateState;
-    bool triggerActive;
-    uint64_t triggerStartTime;
-    
-    // Current parameters
-    uint8_t currentAlgorithm;
-    float frequency;
-    float currentFrequency;
-    float baseFrequency;
-    float algorithmParam;
+    typedef TockusEngine<TOCKUS_SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE, TOCKUS_VOICES, false, AlgorithmProbe,
+                         OversampleAlgorithms<TOCKUS_OVERSAMPLING, TOCKUS_ALIASING_ALGORITHMS>, TOCKUS_MODAL_MODES>
+        Engine;
     
-    // Envelope parameters
-    float envAmplitude;
-    float envFrequency;
-    float envDecayRate;
-    
-    // Phase accumulator
-    float phase;
+    Engine engine;
+    RenderProfiler* profiler;
+    bool lastGateState;
     uint64_t sampleCount;
     
-    // Noise generator state
-    uint32_t noiseState;
+    // Control thread -> render thread events
+    SpscQueue<ParameterEvent, PARAMETER_QUEUE_SIZE> parameterQueue;
     
-    // Algorithm-specific parameters
-    float snareNoiseAmp;
-    float snareToneAmp;
-    float hihatEnvelope;
-    float clapPulseEnv;
-    float clapReverbEnv;
-    float bassFilterEnv;
-    float bassImpulse;
-    float cowbellPhases[4];
+    // Render thread -> UI state
+    std::atomic<uint8_t> displayAlgorithm;
+    std::atomic<float> displayFrequency;
+    std::atomic<float> displayAmplitude;
+    std::atomic<int> displayVoiceCount;
+    std::atomic<uint64_t> displaySampleCount;
     
-    // Filter instances
-    BandpassFilter bpf;
-    ResonantFilter bassFilter;
-    
-    // Karplus-Strong parameters
-    float karplusBuffer[KARPLUS_BUFFER_SIZE];
-    int karplusIndex;
-    float karplusDamping;
-    
-    // Modal synthesis parameters
-    Mode modes[NUM_MODES];
-    
-    // Anti-aliasing filter
-    float lastSample;
-    const float LOWPASS_ALPHA = 0.7f;
-    
-    // Core DSP functions (ported from Arduino)
-    void initializeEnvelopes();
-    void updateEnvelopes(float timeElapsed);
-    void updateRealtimeFrequency();
-    float applyAlgorithmFrequencyScaling(float baseFreq, uint8_t algorithm);
-    
-    // Drum generators (ported from Arduino)
-    float generateDrumSample(float timeElapsed);
-    float generateBassDrum(float timeElapsed);
-    float generateZapSound(float timeElapsed);
-    float generateSnareDrum(float timeElapsed);
-    float generateHiHat(float timeElapsed);
-    float generateKarplusStrong(float timeElapsed);
-    float generateModalSynthesis(float timeElapsed);
-    float generateClap(float timeElapsed);
-    float generateCowbell(float timeElapsed);
-    
-    // Utility functions
-    float generateWhiteNoise();
+    void render(float* out, int frames);
+    void publishDisplayState();
     uint64_t getTimeMs();
-    
-    // Filter functions (ported from Arduino)
-    void initializeBandpassFilter();
-    void setBandpassFilter(float centerFreq, float Q);
-    float processBandpassFilter(float input);
-    
-    void initializeResonantFilter();
-    void updateResonantFilter(ResonantFilter* filter, float cutoff, float resonance);
-    float processResonantFilter(ResonantFilter* filter, float input);
-    
-    void initializeKarplusStrong();
-    void initializeModalSynthesis();
-    void setupModalModes();
-    
-    // Authentic cowbell frequencies from Arduino
-    static const float cowbellFreqs[4];
 };
 
 #endif // TOCKUS_DSP_H
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef WAV_WRITER_H
+#define WAV_WRITER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Minimal WAV file writer
+ *
+ * Writes mono 16-bit PCM, the same format the PT8211 receives on hardware.
+ * Float input is clamped to [-1, 1].
+ */
+inline void writeWavLE(FILE* file, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        fputc((value >> (8 * i)) & 0xFF, file);
+    }
+}
+
+inline bool writeWavFile(const char* path, const std::vector<float>& samples, int sampleRate) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    const uint32_t dataBytes = (uint32_t)samples.size() * 2;
+
+    // RIFF header
+    fwrite("RIFF", 1, 4, file);
+    writeWavLE(file, 36 + dataBytes, 4);
+    fwrite("WAVE", 1, 4, file);
+
+    // Format chunk: PCM, mono, 16-bit
+    fwrite("fmt ", 1, 4, file);
+    writeWavLE(file, 16, 4);
+    writeWavLE(file, 1, 2);
+    writeWavLE(file, 1, 2);
+    writeWavLE(file, sampleRate, 4);
+    writeWavLE(file, sampleRate * 2, 4);
+    writeWavLE(file, 2, 2);
+    writeWavLE(file, 16, 2);
+
+    // Sample data
+    fwrite("data", 1, 4, file);
+    writeWavLE(file, dataBytes, 4);
+    for (float sample : samples) {
+        sample = std::max(-1.0f, std::min(sample, 1.0f));
+        writeWavLE(file, (uint16_t)(int16_t)(sample * 32767.0f), 2);
+    }
+
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+#endif // WAV_WRITER_H
@@ -0,0 +1,107 @@
+#ifndef WREN_VOICE_H
+#define WREN_VOICE_H
+
+#include "FixedPoint.h"
+#include "Oversampling.h"
+#include "modulation.h"
+#include "oscillator.h"
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * One Wren oscillator voice on the desktop
+ *
+ * Wren.ino's renderFrame() for a single centred unison voice at a held
+ * pitch, through the firmware's oscillator.h: the table is the mipmap
+ * level the firmware would pick, the amount is smoothed at control rate as
+ * updateParameters() does, and the modes in `OversampledModes` go through
+ * the half-band decimator when `Oversampling` > 1. `FixedPointDsp` selects
+ * the FIXED_POINT_DSP 1 phase accumulator and Q15 mix. Dither is left out,
+ * so renders are deterministic.
+ */
+template <bool FixedPointDsp = false, int Oversampling = 1,
+          unsigned OversampledModes = (1 << MOD_WAVEFOLDING) | (1 << MOD_OVERFLOW)>
+class WrenVoice {
+public:
+    typedef typename std::conditional<FixedPointDsp, uint32_t, float>::type Phase;
+    typedef typename std::conditional<FixedPointDsp, int32_t, float>::type DecimatedMix;  // Q29 when fixed
+
+    // Restart at phase 0 on the mipmaps of `table` (WAVETABLE_SIZE 16-bit
+    // unsigned samples), amount at 0
+    void start(const uint16_t* table, float frequency, int sampleRate) {
+        buildMipmapLevels(table, mipmaps);
+        playbackTable = mipmaps[selectMipmapLevel(frequency, (float)sampleRate)];
+        phase = 0;
+        if constexpr (FixedPointDsp) {
+            increment = phaseIncrement(frequency, (float)sampleRate);
+        } else {
+            increment = frequency * (1.0f / sampleRate);
+        }
+        smoothedAmount = 0.0f;
+        params = MODULATION_PARAMS_INIT;
+        decimating = false;
+    }
+
+    // Control-rate update towards `target`
+    void setAmount(float target) {
+        smoothedAmount = smoothedAmount * 0.95f + target * 0.05f;
+        updateModulationParams(params, smoothedAmount);
+    }
+
+    float process(uint8_t mode) {
+        const bool modulate = smoothedAmount > 0.0f;
+
+        float output;
+        if (Oversampling > 1 && (OversampledModes & (1u << mode))) {
+            if (!decimating) {
+                decimator.reset();
+                decimating = true;
+            }
+
+            DecimatedMix sub[Oversampling];
+            for (int step = 0; step < Oversampling; step++) {
+                sub[step] = mix(step, Oversampling, modulate, mode);
+            }
+            output = toFloat(decimator.process(sub));
+        } else {
+            decimating = false;
+            output = toFloat(mix(0, 1, modulate, mode));
+        }
+
+        phase = advanceOscillatorPhase(phase, increment);
+        return output;
+    }
+
+private:
+    // Unity-gain voice at the decimator's input format
+    DecimatedMix mix(int step, int steps, bool modulate, uint8_t mode) const {
+        if constexpr (FixedPointDsp) {
+            q15_t sample = oscillatorSampleQ15(playbackTable, phase, increment, step, steps, modulate, mode,
+                                               smoothedAmount, params);
+            return (DecimatedMix)(((int64_t)sample * 65536) >> 2);
+        } else {
+            return oscillatorSample(playbackTable, phase, increment, step, steps, modulate, mode, smoothedAmount,
+                                    params);
+        }
+    }
+
+    // Q29 back to Q15 as renderFrame() truncates it, then to float
+    static float toFloat(DecimatedMix mix) {
+        if constexpr (FixedPointDsp) {
+            return q15ToFloat(saturateQ15((int32_t)(((int64_t)mix * 4) >> 16)));
+        } else {
+            return mix;
+        }
+    }
+
+    uint16_t mipmaps[MIPMAP_LEVELS][WAVETABLE_SIZE] = {};
+    const uint16_t* playbackTable = mipmaps[0];
+    Phase phase = 0;
+    Phase increment = 0;
+    float smoothedAmount = 0.0f;
+    ModulationParams params = MODULATION_PARAMS_INIT;
+    Decimator<DecimatedMix, Oversampling> decimator;
+    bool decimating = false;
+};
+
+#endif // WREN_VOICE_H
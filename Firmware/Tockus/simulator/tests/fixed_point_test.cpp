@@ -0,0 +1,222 @@
+/**
+ * Fixed-point DSP closeness test
+ *
+ * Runs the FixedPoint.h building blocks (used by the firmwares when
+ * FIXED_POINT_DSP is 1) next to the float code they replace and checks
+ * the worst-case difference in Q15 LSBs (1 LSB = 1/32768).
+ */
+
+#include "FixedPoint.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+
+static const float SAMPLE_RATE = 44100.0f;
+static const float LSB = 1.0f / 32768.0f;
+
+static int failures = 0;
+
+static void check(const char* name, float maxError, float limitLSB) {
+    bool pass = maxError <= limitLSB * LSB;
+    printf("%-32s max error %8.3f LSB (limit %5.1f)  %s\n",
+           name, maxError / LSB, limitLSB, pass ? "ok" : "FAIL");
+    if (!pass) {
+        failures++;
+    }
+}
+
+static uint32_t noiseState = 1;
+
+static float whiteNoise() {
+    noiseState = noiseState * 1103515245 + 12345;
+    return ((noiseState >> 16) & 0x7FFF) / 32768.0f - 1.0f;
+}
+
+// Wren renderSample(): float phase, float interpolation over the table
+static void testWavetable() {
+    uint16_t table[32];
+    for (int i = 0; i < 32; i++) {
+        noiseState = noiseState * 1103515245 + 12345;
+        table[i] = (uint16_t)(noiseState >> 16);
+    }
+
+    PhaseAccumulator oscillator;
+    oscillator.reset();
+    oscillator.setFrequency(1234.5f, SAMPLE_RATE);
+
+    float maxError = 0.0f;
+    for (int n = 0; n < 44100; n++) {
+        uint32_t phaseBits = oscillator.next();
+
+        // Float path at the same phase
+        float phase = (float)(phaseBits * (1.0 / 4294967296.0));
+        float tablePos = phase * 32;
+        int index = (int)tablePos;
+        float frac = tablePos - index;
+        uint16_t sample1 = table[index % 32];
+        uint16_t sample2 = table[(index + 1) % 32];
+        float expected = ((sample1 + frac * (sample2 - sample1)) - 32768.0f) / 32768.0f;
+
+        float actual = q15ToFloat(wavetableLookupQ15(table, 5, phaseBits));
+        maxError = std::fmax(maxError, std::fabs(actual - expected));
+    }
+    check("wavetable interpolation", maxError, 1.0f);
+}
+
+// Phase drift against a float accumulator over one second
+static void testPhaseAccumulator() {
+    const float frequencies[] = { 20.0f, 440.0f, 8000.0f };
+    float maxError = 0.0f;
+
+    for (float frequency : frequencies) {
+        PhaseAccumulator oscillator;
+        oscillator.reset();
+        oscillator.setFrequency(frequency, SAMPLE_RATE);
+
+        double phase = 0.0;
+        for (int n = 0; n < 44100; n++) {
+            oscillator.next();
+            phase += frequency / SAMPLE_RATE;
+            if (phase >= 1.0) phase -= 1.0;
+        }
+
+        double error = std::fabs(oscillator.toFloat() - phase);
+        maxError = std::fmax(maxError, (float)std::fmin(error, 1.0 - error));
+    }
+    // Phase error in cycles, reported on the same LSB scale
+    check("phase accumulator (1 s)", maxError, 4.0f);
+}
+
+// Tockus DecayEnvelope against DecayEnvelopeQ31
+static void testDecayEnvelope() {
+    const float rates[] = { 2.0f, 20.0f, 200.0f };
+    float maxError = 0.0f;
+
+    for (float rate : rates) {
+        float coeff = std::exp(-rate / SAMPLE_RATE);
+        float value = 1.0f;
+
+        DecayEnvelopeQ31 envelope;
+        envelope.trigger(coeff);
+
+        for (int n = 0; n < 44100; n++) {
+            float expected = value;
+            value *= coeff;
+            float actual = q31ToFloat(envelope.process());
+            maxError = std::fmax(maxError, std::fabs(actual - expected));
+        }
+    }
+    check("decay envelope", maxError, 1.0f);
+}
+
+// Float biquad exactly as Tockus processBandpassFilter/processResonantFilter
+struct FloatBiquad {
+    float a0, a1, a2, b1, b2;
+    float x1, x2, y1, y2;
+
+    float process(float input) {
+        float output = a0 * input + a1 * x1 + a2 * x2 - b1 * y1 - b2 * y2;
+        x2 = x1;
+        x1 = input;
+        y2 = y1;
+        y1 = output;
+        return output;
+    }
+};
+
+struct BiquadErrors {
+    float versusFloat;   // Fixed-point against the firmware float path
+    float versusDouble;  // Fixed-point against a double-precision reference
+};
+
+static BiquadErrors runBiquad(FloatBiquad reference, bool impulse, int samples) {
+    BiquadQ31 fixed;
+    fixed.reset();
+    fixed.setCoefficients(reference.a0, reference.a1, reference.a2, reference.b1, reference.b2);
+    reference.x1 = reference.x2 = reference.y1 = reference.y2 = 0.0f;
+
+    double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+
+    noiseState = 1;
+    BiquadErrors errors = { 0.0f, 0.0f };
+    for (int n = 0; n < samples; n++) {
+        // Bass: 2ms linear impulse like generateBassDrum; others: noise
+        float input = impulse ? (n < 88 ? 1.0f - n / 88.0f : 0.0f) : whiteNoise();
+
+        double exact = reference.a0 * (double)input + reference.a1 * x1 + reference.a2 * x2
+                       - reference.b1 * y1 - reference.b2 * y2;
+        x2 = x1;
+        x1 = input;
+        y2 = y1;
+        y1 = exact;
+
+        float expected = reference.process(input);
+        float actual = fixed.processFloat(input);
+        errors.versusFloat = std::fmax(errors.versusFloat, std::fabs(actual - expected));
+        errors.versusDouble = std::fmax(errors.versusDouble, (float)std::fabs(actual - exact));
+    }
+    return errors;
+}
+
+static void checkBiquad(const char* name, const FloatBiquad& reference, bool impulse, float floatLimitLSB) {
+    BiquadErrors errors = runBiquad(reference, impulse, 44100);
+    char label[64];
+    snprintf(label, sizeof(label), "%s vs float", name);
+    check(label, errors.versusFloat, floatLimitLSB);
+    snprintf(label, sizeof(label), "%s vs double", name);
+    check(label, errors.versusDouble, 1.0f);
+}
+
+static FloatBiquad bandpass(float centerFreq, float Q) {
+    float w = 2.0f * (float)M_PI * centerFreq / SAMPLE_RATE;
+    float alpha = std::sin(w) / (2.0f * Q);
+    float norm = 1.0f / (1.0f + alpha);
+    FloatBiquad f = {};
+    f.a0 = alpha * norm;
+    f.a1 = 0.0f;
+    f.a2 = -alpha * norm;
+    f.b1 = -2.0f * std::cos(w) * norm;
+    f.b2 = (1.0f - alpha) * norm;
+    return f;
+}
+
+static FloatBiquad resonantLowpass(float cutoff, float resonance) {
+    float w = 2.0f * (float)M_PI * cutoff / SAMPLE_RATE;
+    float cosw = std::cos(w);
+    float alpha = std::sin(w) / (2.0f * resonance);
+    float norm = 1.0f / (1.0f + alpha);
+    FloatBiquad f = {};
+    f.a0 = (1.0f - cosw) * 0.5f * norm;
+    f.a1 = (1.0f - cosw) * norm;
+    f.a2 = (1.0f - cosw) * 0.5f * norm;
+    f.b1 = -2.0f * cosw * norm;
+    f.b2 = (1.0f - alpha) * norm;
+    return f;
+}
+
+static void testBiquads() {
+    // Snare, clap, cowbell and hi-hat bandpass settings
+    checkBiquad("bandpass 800Hz Q2", bandpass(800.0f, 2.0f), false, 1.0f);
+    checkBiquad("bandpass 1kHz Q3", bandpass(1000.0f, 3.0f), false, 1.0f);
+    checkBiquad("bandpass 5kHz Q4", bandpass(5000.0f, 4.0f), false, 1.0f);
+    checkBiquad("bandpass 10kHz Q3", bandpass(10000.0f, 3.0f), false, 1.0f);
+
+    // Bass drum near self-oscillation. Here the float path itself drifts
+    // a few LSB from the exact response, so the float limit is wider.
+    checkBiquad("resonant 20Hz Q20", resonantLowpass(20.0f, 20.0f), true, 8.0f);
+    checkBiquad("resonant 80Hz Q20", resonantLowpass(80.0f, 20.0f), true, 8.0f);
+}
+
+int main() {
+    testWavetable();
+    testPhaseAccumulator();
+    testDecayEnvelope();
+    testBiquads();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
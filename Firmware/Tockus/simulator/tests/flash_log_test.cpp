@@ -0,0 +1,268 @@
+/**
+ * FlashLog power-cut and recycle test
+ *
+ * Runs the firmware's wear-leveled record log (FlashLog.cpp, as Wren uses
+ * it) on a simulated NOR flash: programs only clear bits, erases go a few
+ * pages per slice, and a "power cut" stops a program or erase part way
+ * through. Checks that every boot finds the newest record of each key
+ * (the write being cut may land or not), that saves never erase while
+ * service() keeps up, and that erases rotate over all sectors. A flash
+ * without erase suspend must see no erase at all once the log runs.
+ */
+
+#include "FlashLog.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+static const uint32_t REGION_OFFSET = 4 * FLASH_LOG_SECTOR_SIZE;
+static const uint32_t REGION_SECTORS = 4;
+static const int ERASE_PAGES_PER_SLICE = 3;
+
+static int failures = 0;
+
+static void check(const char* name, bool pass) {
+    printf("%-48s %s\n", name, pass ? "ok" : "FAIL");
+    if (!pass) {
+        failures++;
+    }
+}
+
+// Simulated flash: the region and the sectors before it
+struct PowerCut {};
+
+static uint8_t flash[REGION_OFFSET + REGION_SECTORS * FLASH_LOG_SECTOR_SIZE];
+static std::mt19937 rng(1);
+static int operations = 0;
+static int cutAt = -1;           // Operation the power is cut in, -1 = never
+static int erasedPages = 0;      // Progress of the suspended erase
+static int blockingErases = 0;   // Erases run to the end in one call (slice 0)
+static int eraseCalls = 0;
+static bool suspendable = true;
+static int sectorErases[REGION_SECTORS] = {};
+
+static const uint8_t* simRead(uint32_t offset) {
+    return flash + offset;
+}
+
+static void simProgram(uint32_t offset, const uint8_t* page) {
+    bool cut = (++operations == cutAt);
+    int length = cut ? (int)(rng() % FLASH_LOG_PAGE_SIZE) : FLASH_LOG_PAGE_SIZE;
+    for (int i = 0; i < length; i++) {
+        flash[offset + i] &= page[i];
+    }
+    if (cut) {
+        throw PowerCut();
+    }
+}
+
+static bool simErase(uint32_t offset, uint32_t sliceMicros) {
+    eraseCalls++;
+    if (sliceMicros == 0 || !suspendable) {
+        blockingErases++;
+    }
+
+    int slicePages = (sliceMicros && suspendable) ? ERASE_PAGES_PER_SLICE : FLASH_LOG_PAGES_PER_SECTOR;
+    for (int i = 0; i < slicePages && erasedPages < FLASH_LOG_PAGES_PER_SECTOR; i++) {
+        uint8_t* page = flash + offset + erasedPages * FLASH_LOG_PAGE_SIZE;
+        if (++operations == cutAt) {
+            // An interrupted erase leaves the page's bits undefined
+            for (int b = 0; b < FLASH_LOG_PAGE_SIZE; b++) {
+                page[b] |= (uint8_t)rng();
+            }
+            erasedPages = 0;
+            throw PowerCut();
+        }
+        memset(page, 0xFF, FLASH_LOG_PAGE_SIZE);
+        erasedPages++;
+    }
+
+    if (erasedPages < FLASH_LOG_PAGES_PER_SECTOR) {
+        return false;
+    }
+    erasedPages = 0;
+    sectorErases[(offset - REGION_OFFSET) / FLASH_LOG_SECTOR_SIZE]++;
+    return true;
+}
+
+static bool simCanSuspend() {
+    return suspendable;
+}
+
+static const FlashLogDevice simFlash = {simRead, simProgram, simErase, simCanSuspend};
+
+typedef std::map<int, std::vector<uint8_t>> Model;
+
+static std::vector<uint8_t> randomPayload() {
+    static const int lengths[] = {8, 65, FLASH_LOG_MAX_PAYLOAD};
+    std::vector<uint8_t> data(lengths[rng() % 3]);
+    for (auto& byte : data) {
+        byte = (uint8_t)rng();
+    }
+    return data;
+}
+
+static bool matches(const FlashLog& log, int key, const std::vector<uint8_t>& data) {
+    uint16_t length;
+    const uint8_t* stored = log.find(key, &length);
+    return stored && length == data.size() && memcmp(stored, data.data(), length) == 0;
+}
+
+static bool matchesModel(const FlashLog& log, const Model& model) {
+    for (const auto& entry : model) {
+        if (!matches(log, entry.first, entry.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Boots of 50 writes each with a few idle service() calls in between; every
+// third boot has the power cut at a random program or erase
+static void testPowerCuts() {
+    memset(flash, 0x5A, sizeof(flash));  // Never formatted
+    Model model;
+    bool recovered = true;
+    bool written = true;
+    int cuts = 0;
+    uint32_t writes = 0;
+
+    for (int boot = 0; boot < 300; boot++) {
+        erasedPages = 0;  // A reboot drops a suspended erase
+        FlashLog log(simFlash);
+        if (!log.begin(REGION_OFFSET, REGION_SECTORS) || !matchesModel(log, model)) {
+            recovered = false;
+            break;
+        }
+
+        cutAt = (boot % 3 == 2) ? operations + 1 + (int)(rng() % 60) : -1;
+        int key = -1;
+        std::vector<uint8_t> data;
+        try {
+            for (int w = 0; w < 50; w++) {
+                key = rng() % 9;
+                data = randomPayload();
+                written = log.write(key, data.data(), data.size()) && written;
+                model[key] = data;
+                key = -1;
+                writes++;
+
+                for (int idle = rng() % 4; idle > 0; idle--) {
+                    log.service();
+                }
+            }
+        } catch (PowerCut&) {
+            // The write being cut may or may not have landed
+            cutAt = -1;
+            cuts++;
+            erasedPages = 0;
+            FlashLog rebooted(simFlash);
+            if (key >= 0 && rebooted.begin(REGION_OFFSET, REGION_SECTORS) && matches(rebooted, key, data)) {
+                model[key] = data;
+            }
+        }
+        cutAt = -1;
+    }
+
+    printf("%u writes, %d power cuts\n", writes, cuts);
+    check("newest record of every key after each boot", recovered);
+    check("every write without a power cut stored", written);
+}
+
+// With service() run to idle between saves, only it erases, in slices,
+// and every sector takes its turn
+static void testBackgroundErase() {
+    memset(flash, 0xFF, sizeof(flash));
+    memset(sectorErases, 0, sizeof(sectorErases));
+    erasedPages = 0;
+
+    FlashLog log(simFlash);
+    bool ok = log.begin(REGION_OFFSET, REGION_SECTORS);
+    blockingErases = 0;
+
+    Model model;
+    for (int w = 0; w < 2000 && ok; w++) {
+        int key = rng() % FLASH_LOG_MAX_KEYS;
+        model[key] = randomPayload();
+        ok = log.write(key, model[key].data(), model[key].size());
+        while (log.service()) {
+        }
+    }
+    check("2000 writes stored", ok && matchesModel(log, model));
+    check("no erase on the save path", blockingErases == 0);
+
+    int fewest = sectorErases[0];
+    int most = sectorErases[0];
+    for (uint32_t sector = 1; sector < REGION_SECTORS; sector++) {
+        fewest = std::min(fewest, sectorErases[sector]);
+        most = std::max(most, sectorErases[sector]);
+    }
+    printf("sector erases: %d to %d per sector\n", fewest, most);
+    check("erases rotate over every sector", fewest > 0 && most - fewest <= 1);
+
+    // Falling behind: the append that reaches the unerased spare finishes it
+    for (int w = 0; w < 3 * FLASH_LOG_PAGES_PER_SECTOR && ok; w++) {
+        int key = w % FLASH_LOG_MAX_KEYS;
+        model[key] = randomPayload();
+        ok = log.write(key, model[key].data(), model[key].size());
+    }
+    check("writes without service() stored", ok && matchesModel(log, model));
+
+    FlashLog rebooted(simFlash);
+    check("reboot finds the same records", rebooted.begin(REGION_OFFSET, REGION_SECTORS) && matchesModel(rebooted, model));
+}
+
+// Without erase suspend: begin() erases, the running log never does; it
+// fills the spare sector, refuses saves, and takes them again after a boot
+static void testNoSuspend() {
+    memset(flash, 0xFF, sizeof(flash));
+    erasedPages = 0;
+    suspendable = false;
+
+    Model model;
+    bool stored = true;
+    bool erasedWhileRunning = false;
+    int accepted[3] = {};
+    for (int boot = 0; boot < 3; boot++) {
+        FlashLog log(simFlash);
+        bool ok = log.begin(REGION_OFFSET, REGION_SECTORS) && matchesModel(log, model);
+        stored = stored && ok && !log.canEraseInBackground();
+
+        eraseCalls = 0;
+        for (int w = 0; w < 4 * FLASH_LOG_PAGES_PER_SECTOR && ok; w++) {
+            int key = rng() % FLASH_LOG_MAX_KEYS;
+            std::vector<uint8_t> data = randomPayload();
+            if (log.write(key, data.data(), data.size())) {
+                model[key] = data;
+                accepted[boot]++;
+            }
+            log.service();
+        }
+        erasedWhileRunning = erasedWhileRunning || eraseCalls > 0;
+        stored = stored && matchesModel(log, model);
+    }
+    suspendable = true;
+
+    printf("saves accepted per boot: %d, %d, %d\n", accepted[0], accepted[1], accepted[2]);
+    check("no suspend: no erase once running", !erasedWhileRunning);
+    check("no suspend: saves stop, then resume after boot",
+          stored && accepted[1] >= FLASH_LOG_PAGES_PER_SECTOR && accepted[2] >= FLASH_LOG_PAGES_PER_SECTOR &&
+          accepted[1] < 4 * FLASH_LOG_PAGES_PER_SECTOR);
+}
+
+int main() {
+    testPowerCuts();
+    testBackgroundErase();
+    testNoSuspend();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,320 @@
+/**
+ * Golden-output regression test
+ *
+ * Renders deterministic hits of every Tockus DrumAlgorithm and every Wren
+ * modulation mode at several pitch/parameter settings and compares them
+ * with the reference renders in tests/golden. A case passes when both
+ *
+ *   SNR            10 log10(sum ref^2 / sum (out - ref)^2)
+ *   spectral error 10 log10(sum (|OUT| - |REF|)^2 / sum |REF|^2)
+ *
+ * clear their limits. The spectral error compares Hann-windowed magnitude
+ * spectra frame by frame, so it tracks timbre and stays meaningful where
+ * a small timing or phase change already sinks the SNR.
+ *
+ * The fixed-point engines (FIXED_POINT_DSP 1 on the firmware) are checked
+ * against the same float references with wider limits.
+ *
+ * Usage: golden_test [--update] GOLDEN_DIR
+ * --update rewrites the references after an intended change in the sound.
+ */
+
+#include "TockusEngine.h"
+#include "FixedPoint.h"
+#include "modulation.h"
+#include "spectrum.h"
+#include "wav_writer.h"
+#include "wren_voice.h"
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int SAMPLE_RATE = 44100;
+
+// Float output like the simulator; voices as on the Tockus firmware
+typedef TockusEngine<SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE, TOCKUS_VOICES> FloatEngine;
+typedef TockusEngine<SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE, TOCKUS_VOICES, true> FixedEngine;
+
+// Pass limits in dB
+struct Limits {
+    double minSnr;
+    double maxSpectralError;
+};
+
+static const Limits FLOAT_LIMITS = { 50.0, -50.0 };
+static const Limits FIXED_LIMITS = { 30.0, -35.0 };
+
+static std::string goldenDir;
+static bool updateMode = false;
+static int failures = 0;
+
+// 16-bit mono PCM as written by writeWavFile(), scaled back to +/-1
+static bool readWavFile(const char* path, std::vector<float>& samples) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        bytes.insert(bytes.end(), buffer, buffer + count);
+    }
+    fclose(file);
+
+    if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) != 0 || memcmp(&bytes[8], "WAVE", 4) != 0) {
+        return false;
+    }
+
+    // Walk the chunks to "data"
+    size_t offset = 12;
+    while (offset + 8 <= bytes.size()) {
+        uint32_t size = bytes[offset + 4] | (bytes[offset + 5] << 8) | (bytes[offset + 6] << 16)
+                        | ((uint32_t)bytes[offset + 7] << 24);
+        if (memcmp(&bytes[offset], "data", 4) == 0) {
+            size_t end = offset + 8 + size;
+            if (end > bytes.size()) {
+                return false;
+            }
+            samples.clear();
+            for (size_t i = offset + 8; i + 1 < end; i += 2) {
+                int16_t value = (int16_t)(bytes[i] | (bytes[i + 1] << 8));
+                samples.push_back(value / 32767.0f);
+            }
+            return true;
+        }
+        offset += 8 + size + (size & 1);
+    }
+    return false;
+}
+
+static double toDb(double numerator, double denominator) {
+    if (numerator <= 0.0) {
+        return -200.0;
+    }
+    if (denominator <= 0.0) {
+        return 200.0;
+    }
+    return 10.0 * std::log10(numerator / denominator);
+}
+
+static double snrDb(const std::vector<float>& output, const std::vector<float>& reference) {
+    double signal = 0.0;
+    double noise = 0.0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        double error = (double)output[i] - reference[i];
+        signal += (double)reference[i] * reference[i];
+        noise += error * error;
+    }
+    return -toDb(noise, signal);
+}
+
+// 1024-point frames, hop 512
+static double spectralErrorDb(const std::vector<float>& output, const std::vector<float>& reference) {
+    const size_t frameSize = 1024;
+    const size_t hop = frameSize / 2;
+
+    std::vector<double> window(frameSize);
+    for (size_t i = 0; i < frameSize; i++) {
+        window[i] = hannWindow(i, frameSize);
+    }
+
+    double difference = 0.0;
+    double energy = 0.0;
+    std::vector<std::complex<double>> out(frameSize);
+    std::vector<std::complex<double>> ref(frameSize);
+    for (size_t start = 0; start + frameSize <= reference.size(); start += hop) {
+        for (size_t i = 0; i < frameSize; i++) {
+            out[i] = output[start + i] * window[i];
+            ref[i] = reference[start + i] * window[i];
+        }
+        fft(out);
+        fft(ref);
+        for (size_t k = 0; k <= frameSize / 2; k++) {
+            double delta = std::abs(out[k]) - std::abs(ref[k]);
+            difference += delta * delta;
+            energy += std::norm(ref[k]);
+        }
+    }
+    return toDb(difference, energy);
+}
+
+// Compare `output` with the reference `name`.wav, or rewrite it in update mode
+static void checkGolden(const char* name, const char* variant, const std::vector<float>& output,
+                        const Limits& limits) {
+    std::string path = goldenDir + "/" + name + ".wav";
+    char label[64];
+    snprintf(label, sizeof(label), "%s%s", name, variant);
+
+    if (updateMode) {
+        // References come from the float paths only
+        if (variant[0] != '\0') {
+            return;
+        }
+        if (!writeWavFile(path.c_str(), output, SAMPLE_RATE)) {
+            printf("%-40s could not write %s\n", label, path.c_str());
+            failures++;
+            return;
+        }
+        printf("%-40s written\n", label);
+        return;
+    }
+
+    std::vector<float> reference;
+    if (!readWavFile(path.c_str(), reference)) {
+        printf("%-40s missing reference %s  FAIL\n", label, path.c_str());
+        failures++;
+        return;
+    }
+    if (reference.size() != output.size()) {
+        printf("%-40s length %zu, reference %zu  FAIL\n", label, output.size(), reference.size());
+        failures++;
+        return;
+    }
+
+    double snr = snrDb(output, reference);
+    double spectral = spectralErrorDb(output, reference);
+    bool pass = snr >= limits.minSnr && spectral <= limits.maxSpectralError;
+    printf("%-40s SNR %6.1f dB (min %3.0f)  spectral %7.1f dB (max %4.0f)  %s\n",
+           label, snr, limits.minSnr, spectral, limits.maxSpectralError, pass ? "ok" : "FAIL");
+    if (!pass) {
+        failures++;
+    }
+}
+
+// Tockus: a hit, then a second one while the first still rings
+static const int TOCKUS_RETRIGGER = SAMPLE_RATE / 20;  // 50 ms
+static const int TOCKUS_FRAMES = SAMPLE_RATE / 4;      // 250 ms
+
+struct TockusCase {
+    float frequency;  // Base frequency before the algorithm's scaling
+    float parameter;
+};
+
+static const TockusCase TOCKUS_CASES[] = {
+    { 110.0f, 0.2f },
+    { 220.0f, 0.5f },
+    { 440.0f, 0.9f },
+};
+
+static const char* const ALGORITHM_NAMES[NUM_ALGORITHMS] = {
+    "bass", "snare", "hihat", "karplus", "modal", "zap", "clap", "cowbell"
+};
+
+template <typename Engine>
+static std::vector<float> renderTockus(uint8_t algorithm, const TockusCase& setting) {
+    static Engine engine;  // Large voice state; one per engine type
+    engine.reset();
+    engine.setControls(Engine::scaleFrequency(setting.frequency, algorithm), algorithm, setting.parameter);
+
+    std::vector<float> output(TOCKUS_FRAMES);
+    engine.trigger();
+    engine.render(&output[0], TOCKUS_RETRIGGER);
+    engine.trigger();
+    engine.render(&output[TOCKUS_RETRIGGER], TOCKUS_FRAMES - TOCKUS_RETRIGGER);
+    return output;
+}
+
+static void testTockus() {
+    for (uint8_t algorithm = 0; algorithm < NUM_ALGORITHMS; algorithm++) {
+        for (const TockusCase& setting : TOCKUS_CASES) {
+            char name[64];
+            snprintf(name, sizeof(name), "tockus_%s_%dhz_p%02d", ALGORITHM_NAMES[algorithm],
+                     (int)setting.frequency, (int)(setting.parameter * 100.0f + 0.5f));
+
+            checkGolden(name, "", renderTockus<FloatEngine>(algorithm, setting), FLOAT_LIMITS);
+            checkGolden(name, " (fixed)", renderTockus<FixedEngine>(algorithm, setting), FIXED_LIMITS);
+        }
+    }
+}
+
+// Wren: one centred voice through the firmware's oscillator.h at the
+// mipmap level for its pitch, the amount target swept from 0 over the
+// first half at control rate, then held. Unison and dither are not covered.
+static const int WREN_FRAMES = 4096;
+static const int WREN_CONTROL_PERIOD = 16;
+
+static const auto WREN_SAW = makeUint16Table<WAVETABLE_SIZE>(TABLE_SAW);
+static const auto WREN_TRIANGLE = makeUint16Table<WAVETABLE_SIZE>(TABLE_TRIANGLE);
+static const auto WREN_PULSE = makeUint16Table<WAVETABLE_SIZE>(TABLE_PULSE, 0.25);
+
+struct WrenCase {
+    const char* tableName;
+    const uint16_t* table;
+    float frequency;
+    float amount;
+};
+
+static const WrenCase WREN_CASES[] = {
+    { "saw", WREN_SAW.values, 110.0f, 0.25f },
+    { "tri", WREN_TRIANGLE.values, 440.0f, 0.6f },
+    { "pulse", WREN_PULSE.values, 1760.0f, 0.9f },
+};
+
+static const char* const MODULATION_NAMES[NUM_MODULATION_TYPES] = {
+    "fold", "overflow", "bitcrush", "pd", "resonance"
+};
+
+static float wrenAmount(const WrenCase& setting, int frame) {
+    int step = frame / WREN_CONTROL_PERIOD * WREN_CONTROL_PERIOD;
+    float ramp = (float)step / (WREN_FRAMES / 2);
+    return setting.amount * (ramp < 1.0f ? ramp : 1.0f);
+}
+
+// FIXED_POINT_DSP 0 or 1 path
+template <typename Voice>
+static std::vector<float> renderWren(uint8_t mode, const WrenCase& setting) {
+    Voice voice;
+    voice.start(setting.table, setting.frequency, SAMPLE_RATE);
+
+    std::vector<float> output(WREN_FRAMES);
+    for (int n = 0; n < WREN_FRAMES; n++) {
+        if (n % WREN_CONTROL_PERIOD == 0) {
+            voice.setAmount(wrenAmount(setting, n));
+        }
+        output[n] = voice.process(mode);
+    }
+    return output;
+}
+
+static void testWren() {
+    for (uint8_t mode = 0; mode < NUM_MODULATION_TYPES; mode++) {
+        for (const WrenCase& setting : WREN_CASES) {
+            char name[64];
+            snprintf(name, sizeof(name), "wren_%s_%s_%dhz_a%02d", MODULATION_NAMES[mode], setting.tableName,
+                     (int)setting.frequency, (int)(setting.amount * 100.0f + 0.5f));
+
+            checkGolden(name, "", renderWren<WrenVoice<>>(mode, setting), FLOAT_LIMITS);
+            checkGolden(name, " (fixed)", renderWren<WrenVoice<true>>(mode, setting), FIXED_LIMITS);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            updateMode = true;
+        } else {
+            goldenDir = argv[i];
+        }
+    }
+    if (goldenDir.empty()) {
+        fprintf(stderr, "usage: %s [--update] GOLDEN_DIR\n", argv[0]);
+        return 2;
+    }
+
+    testTockus();
+    testWren();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf(updateMode ? "references written\n" : "all checks passed\n");
+    return 0;
+}
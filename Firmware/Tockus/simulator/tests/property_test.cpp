@@ -0,0 +1,338 @@
+/**
+ * Property checks for the build-time render configurations
+ *
+ * golden_test covers the engine as the firmware ships it. This covers
+ * the configurations its references can't pin down, by measurement:
+ *
+ * - Decimator (Oversampling.h), float and Q31: passband ripple up to
+ *   18kHz, and how far down every alias that folds below 16kHz is
+ * - TOCKUS_OVERSAMPLING 2 and 4: the algorithms that stay at 1x render
+ *   bit-identical to the 1x engine, the oversampled ones keep their level
+ *   and the cowbell's inharmonic (alias) energy drops with the factor
+ * - TOCKUS_MODAL_MODES 8 and 16: every mode rings at its ratio of the
+ *   base frequency and decays at its rate, modes past the resonator's
+ *   limit stay silent, and the mix keeps the 4-mode level
+ */
+
+#include "TockusEngine.h"
+#include "Oversampling.h"
+#include "spectrum.h"
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+static const int SAMPLE_RATE = 44100;
+
+static int failures = 0;
+
+static void check(const char* name, bool pass, const char* detail) {
+    printf("%-44s %-36s %s\n", name, detail, pass ? "ok" : "FAIL");
+    if (!pass) {
+        failures++;
+    }
+}
+
+static double toDb(double ratio) {
+    return 20.0 * std::log10(ratio > 1e-12 ? ratio : 1e-12);
+}
+
+// Decimator: a half-scale sine at `frequency` (input rate Factor x 44.1kHz)
+// in, gain in dB at the frequency it lands on at 44.1kHz
+template <typename T, int Factor>
+static double decimatorGainDb(double frequency) {
+    const int frames = 8192;
+    const int settle = 256;
+    const double amplitude = 0.5;
+
+    Decimator<T, Factor> decimator;
+    std::vector<double> output;
+    T input[Factor];
+    for (int m = 0; m < frames + settle; m++) {
+        for (int k = 0; k < Factor; k++) {
+            double x = amplitude * std::sin(2.0 * M_PI * frequency * (m * Factor + k) / (SAMPLE_RATE * Factor));
+            input[k] = std::is_floating_point<T>::value ? (T)x : (T)(x * 2147483648.0);
+        }
+        T y = decimator.process(input);
+        if (m >= settle) {
+            output.push_back(std::is_floating_point<T>::value ? (double)y : y / 2147483648.0);
+        }
+    }
+
+    double folded = std::fmod(frequency, (double)SAMPLE_RATE);
+    if (folded > SAMPLE_RATE / 2) {
+        folded = SAMPLE_RATE - folded;
+    }
+    return toDb(amplitudeAt(output, 0, frames, folded / SAMPLE_RATE) / amplitude);
+}
+
+// Limits from the Oversampling.h design notes
+template <typename T, int Factor>
+static void testDecimator(const char* name, double minAttenuation) {
+    double ripple = 0.0;
+    for (double frequency = 50.0; frequency <= 18000.0; frequency += 250.0) {
+        ripple = std::fmax(ripple, std::fabs(decimatorGainDb<T, Factor>(frequency)));
+    }
+
+    double worstAlias = -300.0;
+    for (double frequency = SAMPLE_RATE - 16000.0; frequency <= SAMPLE_RATE * Factor / 2.0; frequency += 330.0) {
+        double folded = std::fmod(frequency, (double)SAMPLE_RATE);
+        if (std::fmin(folded, SAMPLE_RATE - folded) <= 16000.0) {
+            worstAlias = std::fmax(worstAlias, decimatorGainDb<T, Factor>(frequency));
+        }
+    }
+
+    char label[64];
+    char detail[64];
+    snprintf(label, sizeof(label), "%s passband ripple to 18kHz", name);
+    snprintf(detail, sizeof(detail), "%.3f dB (max 0.05)", ripple);
+    check(label, ripple <= 0.05, detail);
+
+    snprintf(label, sizeof(label), "%s aliases below 16kHz", name);
+    snprintf(detail, sizeof(detail), "%.1f dB (max %.0f)", worstAlias, -minAttenuation);
+    check(label, worstAlias <= -minAttenuation, detail);
+}
+
+// Engines as the simulator builds them for TOCKUS_OVERSAMPLING 1, 2 and 4
+typedef TockusEngine<SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE, TOCKUS_VOICES> BaseEngine;
+
+template <int Factor>
+using OversampledEngine = TockusEngine<SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE, TOCKUS_VOICES, false, NullRenderProbe,
+                                       OversampleAlgorithms<Factor, TOCKUS_ALIASING_ALGORITHMS>>;
+
+static const int HIT_FRAMES = 8192;
+
+template <typename Engine>
+static std::vector<float> renderHit(uint8_t algorithm, float frequency, float parameter) {
+    static Engine engine;  // Large voice state; one per engine type
+    engine.reset();
+    engine.setControls(Engine::scaleFrequency(frequency, algorithm), algorithm, parameter);
+
+    std::vector<float> output(HIT_FRAMES);
+    engine.trigger();
+    engine.render(&output[0], HIT_FRAMES);
+    return output;
+}
+
+static double rms(const std::vector<float>& x) {
+    double sum = 0.0;
+    for (float sample : x) {
+        sum += (double)sample * sample;
+    }
+    return std::sqrt(sum / x.size());
+}
+
+// Energy below 16kHz away from the odd harmonics of the four 808
+// oscillators, relative to the energy on them
+static double cowbellAliasDb(const std::vector<float>& output) {
+    static const double frequencies[4] = { 555.0, 835.0, 1370.0, 1940.0 };
+    const double binWidth = (double)SAMPLE_RATE / HIT_FRAMES;
+
+    std::vector<std::complex<double>> spectrum(HIT_FRAMES);
+    for (int n = 0; n < HIT_FRAMES; n++) {
+        spectrum[n] = output[n] * hannWindow(n, HIT_FRAMES);
+    }
+    fft(spectrum);
+
+    double harmonic = 0.0;
+    double alias = 0.0;
+    for (int k = 1; k * binWidth <= 16000.0; k++) {
+        double frequency = k * binWidth;
+        bool onHarmonic = false;
+        for (double fundamental : frequencies) {
+            for (int m = 1; m * fundamental < SAMPLE_RATE / 2; m += 2) {
+                onHarmonic = onHarmonic || std::fabs(frequency - m * fundamental) < 4.0 * binWidth;
+            }
+        }
+        (onHarmonic ? harmonic : alias) += std::norm(spectrum[k]);
+    }
+    return 10.0 * std::log10(alias / harmonic);
+}
+
+static const char* const ALGORITHM_NAMES[NUM_ALGORITHMS] = {
+    "bass", "snare", "hihat", "karplus", "modal", "zap", "clap", "cowbell"
+};
+
+// Oversampled algorithms stay within 3dB of their 1x level: the hi-hat's
+// noise loses the share that folded back into the audio band at 1x
+template <int Factor>
+static void testOversampledEngine() {
+    char label[64];
+    char detail[64];
+
+    for (uint8_t algorithm = 0; algorithm < NUM_ALGORITHMS; algorithm++) {
+        std::vector<float> base = renderHit<BaseEngine>(algorithm, 220.0f, 0.5f);
+        std::vector<float> oversampled = renderHit<OversampledEngine<Factor>>(algorithm, 220.0f, 0.5f);
+
+        if (TOCKUS_ALIASING_ALGORITHMS & ALGORITHM_BIT(algorithm)) {
+            double level = toDb(rms(oversampled) / rms(base));
+            snprintf(label, sizeof(label), "%dx %s level against 1x", Factor, ALGORITHM_NAMES[algorithm]);
+            snprintf(detail, sizeof(detail), "%+.2f dB (max +/-3)", level);
+            check(label, std::fabs(level) <= 3.0, detail);
+        } else {
+            bool identical = true;
+            for (int n = 0; n < HIT_FRAMES; n++) {
+                identical = identical && oversampled[n] == base[n];
+            }
+            snprintf(label, sizeof(label), "%dx %s unchanged (not oversampled)", Factor, ALGORITHM_NAMES[algorithm]);
+            check(label, identical, identical ? "bit-identical" : "differs");
+        }
+    }
+}
+
+// Each doubling of the cowbell's rate takes at least 4dB off its aliases
+static void testCowbellAliasing() {
+    const float parameters[] = { 0.2f, 0.9f };
+    for (float parameter : parameters) {
+        double base = cowbellAliasDb(renderHit<BaseEngine>(ALGO_COWBELL, 440.0f, parameter));
+        double twice = cowbellAliasDb(renderHit<OversampledEngine<2>>(ALGO_COWBELL, 440.0f, parameter));
+        double four = cowbellAliasDb(renderHit<OversampledEngine<4>>(ALGO_COWBELL, 440.0f, parameter));
+
+        char label[64];
+        char detail[64];
+        snprintf(label, sizeof(label), "cowbell p%02d alias energy 1x/2x/4x", (int)(parameter * 100.0f + 0.5f));
+        snprintf(detail, sizeof(detail), "%.1f / %.1f / %.1f dB", base, twice, four);
+        check(label, twice <= base - 4.0 && four <= twice - 4.0, detail);
+    }
+}
+
+// Engines as the simulator builds them for TOCKUS_MODAL_MODES 4, 8 and 16
+template <int Modes>
+using ModalEngine = TockusEngine<SAMPLE_RATE, float, TOCKUS_BLOCK_SIZE, TOCKUS_VOICES, false, NullRenderProbe,
+                                 NoOversampling, Modes>;
+
+// TockusEngine.h's modal tables, and the decay it derives from the parameter
+static const double MODAL_RATIOS[16] = {
+    1.0, 1.6, 2.3, 3.1, 3.65, 4.06, 4.6, 5.13, 5.4, 5.95, 6.5, 7.05, 7.6, 8.2, 8.8, 9.4
+};
+static const double MODAL_AMPLITUDES[16] = {
+    1.0, 0.7, 0.5, 0.3, 0.28, 0.24, 0.2, 0.17, 0.15, 0.13, 0.11, 0.1, 0.09, 0.08, 0.07, 0.06
+};
+static const double MODAL_DECAY_RATIOS[16] = {
+    1.0, 1.3, 1.8, 2.5, 2.8, 3.2, 3.6, 4.0, 4.5, 5.0, 5.5, 6.0, 6.5, 7.0, 7.5, 8.0
+};
+
+static double modalBaseDecay(float parameter) {
+    return 2.0 + parameter * 8.0;
+}
+
+// Each mode is measured by a lock-in at its frequency over two windows
+// 50ms apart. Its decay is taken relative to mode 0's, which removes the
+// shared amplitude envelope. Returns mode 0's starting amplitude, which
+// the 8 and 16 mode builds compare with the 4 mode one's (`reference`).
+template <int Modes>
+static double testModalModes(float frequency, float parameter, double reference) {
+    const int frames = 4096;
+    const int gap = SAMPLE_RATE / 20;
+
+    static ModalEngine<Modes> engine;
+    engine.reset();
+    engine.setControls(ModalEngine<Modes>::scaleFrequency(frequency, ALGO_MODAL), ALGO_MODAL, parameter);
+    std::vector<float> output(frames + gap);
+    engine.trigger();
+    engine.render(&output[0], frames + gap);
+
+    const double base = engine.getFrequency() / SAMPLE_RATE;
+    const double decayTime = (double)gap / SAMPLE_RATE;
+    const double start0 = amplitudeAt(output, 0, frames, base);
+    const double decay0 = std::log(start0 / amplitudeAt(output, gap, frames, base)) / decayTime;
+
+    double worstPitch = 0.0;   // %
+    double worstDecay = 0.0;   // % of the expected relative decay
+    double loudestMuted = 0.0;
+    int ringing = 0;
+    for (int mode = 0; mode < Modes; mode++) {
+        double cycles = base * MODAL_RATIOS[mode];
+        if (cycles >= RESONATOR_MAX_CYCLES) {
+            loudestMuted = std::fmax(loudestMuted, amplitudeAt(output, 0, frames, cycles) / start0);
+            continue;
+        }
+        ringing++;
+
+        // Strongest response within +/-2% of the expected frequency
+        double peak = cycles;
+        double peakAmplitude = 0.0;
+        for (double probe = cycles * 0.98; probe <= cycles * 1.02; probe += cycles * 0.0002) {
+            double amplitude = amplitudeAt(output, 0, frames, probe);
+            if (amplitude > peakAmplitude) {
+                peakAmplitude = amplitude;
+                peak = probe;
+            }
+        }
+        worstPitch = std::fmax(worstPitch, 100.0 * std::fabs(peak / cycles - 1.0));
+
+        if (mode > 0) {
+            double start = amplitudeAt(output, 0, frames, cycles);
+            double decay = std::log(start / amplitudeAt(output, gap, frames, cycles)) / decayTime - decay0;
+            double expected = modalBaseDecay(parameter) * (MODAL_DECAY_RATIOS[mode] - 1.0);
+            worstDecay = std::fmax(worstDecay, 100.0 * std::fabs(decay / expected - 1.0));
+        }
+    }
+
+    char label[64];
+    char detail[64];
+    int percent = (int)(parameter * 100.0f + 0.5f);
+    snprintf(label, sizeof(label), "%d modes %.0fHz p%02d pitch", Modes, frequency, percent);
+    snprintf(detail, sizeof(detail), "%d ringing, %.3f%% (max 0.1)", ringing, worstPitch);
+    check(label, worstPitch <= 0.1, detail);
+
+    snprintf(label, sizeof(label), "%d modes %.0fHz p%02d decay", Modes, frequency, percent);
+    snprintf(detail, sizeof(detail), "%.2f%% (max 5)", worstDecay);
+    check(label, worstDecay <= 5.0, detail);
+
+    if (ringing < Modes) {
+        snprintf(label, sizeof(label), "%d modes %.0fHz p%02d past the limit", Modes, frequency, percent);
+        snprintf(detail, sizeof(detail), "%d silent, %.1f dB", Modes - ringing, toDb(loudestMuted));
+        check(label, loudestMuted < 1e-4, detail);
+    }
+
+    if (Modes == 4) {
+        return start0;
+    }
+
+    // modalGain scales the mix by the 4 mode amplitude sum over this one's
+    double amplitudeSum4 = 0.0;
+    double amplitudeSum = 0.0;
+    for (int mode = 0; mode < Modes; mode++) {
+        amplitudeSum += MODAL_AMPLITUDES[mode];
+        amplitudeSum4 += mode < 4 ? MODAL_AMPLITUDES[mode] : 0.0;
+    }
+    double level = toDb(start0 / reference / (amplitudeSum4 / amplitudeSum));
+    snprintf(label, sizeof(label), "%d modes %.0fHz p%02d level", Modes, frequency, percent);
+    snprintf(detail, sizeof(detail), "%+.2f dB against 4 modes (max +/-0.5)", level);
+    check(label, std::fabs(level) <= 0.5, detail);
+    return start0;
+}
+
+// A low setting where all 16 modes ring, and a high one where the top
+// modes pass the resonator's limit
+static void testModalBuilds() {
+    const float settings[2][2] = { { 55.0f, 0.2f }, { 220.0f, 0.7f } };
+    for (const auto& setting : settings) {
+        double reference = testModalModes<4>(setting[0], setting[1], 0.0);
+        testModalModes<8>(setting[0], setting[1], reference);
+        testModalModes<16>(setting[0], setting[1], reference);
+    }
+}
+
+int main() {
+    testDecimator<float, 2>("float 2x", 80.0);
+    testDecimator<float, 4>("float 4x", 68.0);
+    testDecimator<float, 8>("float 8x", 68.0);
+    testDecimator<int32_t, 2>("Q31 2x", 80.0);
+    testDecimator<int32_t, 4>("Q31 4x", 68.0);
+
+    testOversampledEngine<2>();
+    testOversampledEngine<4>();
+    testCowbellAliasing();
+    testModalBuilds();
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -17,11 +17,23 @@
  */
 
 #include <I2S.h>
+#include <AudioOutput.h>
+#include <FixedPoint.h>
+#include <Controls.h>
+#include <Crc.h>
+#include <FlashLog.h>
+#include <GateCapture.h>
+#include <Telemetry.h>
+#include <Oversampling.h>
 #include <EEPROM.h>
 #include <FastLED.h>
 #include <pico/multicore.h>
+#include <hardware/flash.h>
+#include <hardware/sync.h>
 #include "waveforms.h"
 #include "sin_table.h"
+#include "modulation.h"
+#include "oscillator.h"
 
 // PT8211S I2S pins
 #define I2S_BCLK 6  // Bit clock
@@ -41,69 +53,186 @@
 #define NUM_LEDS 1
 CRGB leds[NUM_LEDS];
 
-// ADC range calibration (from CLAUDE.md)
-#define PITCH_CV_MIN 0
-#define PITCH_CV_MAX 4095
-#define PITCH_KNOB_MIN 10
-#define PITCH_KNOB_MAX 4000
-#define CV1_MIN 8
-#define CV1_MAX 2000
-#define CV2_MIN 8
-#define CV2_MAX 2000
-
 // Create I2S instance for PT8211S
 I2S i2s(OUTPUT, I2S_BCLK, I2S_DOUT);
 
-// Wavetable parameters
-const int WAVETABLE_SIZE = 32;                                                 // 32 samples per waveform
+// DMA double-buffered output, rendered in blocks of AUDIO_BUFFER_FRAMES
+#define AUDIO_BUFFER_FRAMES 64
+AudioOutput audioOutput(i2s);
+
+// Wavetable parameters (WAVETABLE_SIZE is in modulation.h)
 const int WAVEFORM_BANKS = 8;                                                  // 8 banks for simpler design
 const int EEPROM_SIZE = WAVETABLE_SIZE * WAVEFORM_BANKS * 2 + WAVEFORM_BANKS;  // +8 bytes for modulation types
 
-// Modulation types
-enum ModulationType {
-  MOD_WAVEFOLDING = 0,  // Default
-  MOD_OVERFLOW = 1,
-  MOD_BITCRUSH = 2,
-  MOD_PHASE_DISTORTION = 3,
-  MOD_RESONANCE = 4,
-  NUM_MODULATION_TYPES = 5
-};
+// DSP arithmetic: 1 = 32-bit phase accumulators, Q15 wavetable read, Q16
+// voice mix and Q31 dither (FixedPoint.h); modulation effects stay float.
+// 0 = float path
+#define FIXED_POINT_DSP 0
+
+// Modulation types rendered at MODULATION_OVERSAMPLING times the sample
+// rate and decimated back (Oversampling.h). Folding and overflow throw
+// harmonics far past Nyquist; the other modes stay at 1x. 1 = off, 2 or 4
+#define MODULATION_OVERSAMPLING 1
+#define OVERSAMPLED_MODULATION ((1 << MOD_WAVEFOLDING) | (1 << MOD_OVERFLOW))
+
+// 1 = time every render block and answer CMD_TELEMETRY with cycles per
+// sample for each modulation type, control latency and I2S underruns
+#define TELEMETRY 0
 
-// Per-bank modulation settings (default to wavefolding)
-uint8_t bankModulationTypes[WAVEFORM_BANKS] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+#if TELEMETRY
+Telemetry<NUM_MODULATION_TYPES> telemetry;
+#endif
 
 // Audio parameters
 const int sampleRate = 44100;
-float frequency = 440.0;
+float frequency = 440.0f;
 const int amplitude = 32767;  // Full scale for maximum S/N ratio
-float phase = 0.0;
-bool gateState = false;
-bool lastGateState = false;
-float wavefoldAmount = 0.0;
-float smoothedWavefoldAmount = 0.0;
-
-// Anti-aliasing filter state
-float antiAliasFilter1 = 0.0;
-float antiAliasFilter2 = 0.0;
-const float AA_CUTOFF = 0.85;  // Anti-aliasing cutoff (85% of Nyquist)
+GateCapture<> gateCapture;  // Hard sync edges, timestamped by the GPIO interrupt
+float wavefoldAmount = 0.0f;
+float smoothedWavefoldAmount = 0.0f;
+ModulationParams modParams = MODULATION_PARAMS_INIT;  // Constants for smoothedWavefoldAmount
+
+// Unison oscillators sharing the playback wavetable, structure of arrays
+// so the render loop walks each array linearly. Increments are refreshed
+// at control rate; detune ratios and pan gains only on CMD_UNISON.
+// One voice is the original single oscillator, centred.
+#define UNISON_MAX_VOICES 7
+#define UNISON_MAX_DETUNE_CENTS 50.0f  // Outer voices at detune 255
+
+uint8_t unisonVoices = 1;
+uint8_t unisonDetune = 0;  // 0-255
+uint8_t unisonSpread = 0;  // 0-255, mono to full stereo width
+float voiceDetuneRatio[UNISON_MAX_VOICES] = { 1.0f };
+float maxDetuneRatio = 1.0f;
+#if FIXED_POINT_DSP
+uint32_t voicePhase[UNISON_MAX_VOICES];
+uint32_t voiceIncrement[UNISON_MAX_VOICES];
+int32_t voiceGainLeft[UNISON_MAX_VOICES] = { 65536 };  // Q16
+int32_t voiceGainRight[UNISON_MAX_VOICES] = { 65536 };
+#else
+float voicePhase[UNISON_MAX_VOICES];
+float voiceIncrement[UNISON_MAX_VOICES];
+float voiceGainLeft[UNISON_MAX_VOICES] = { 1.0f };
+float voiceGainRight[UNISON_MAX_VOICES] = { 1.0f };
+#endif
+
+// Half-band decimators for the oversampled modes, reset on entry so a
+// mode change never replays a stale tail. The fixed-point mix enters as
+// Q29, two bits of headroom for the unison sum.
+#if FIXED_POINT_DSP
+typedef int64_t VoiceMix;     // Q31
+typedef int32_t DecimatedMix;  // Q29
+#else
+typedef float VoiceMix;
+typedef float DecimatedMix;
+#endif
+Decimator<DecimatedMix, MODULATION_OVERSAMPLING> decimatorLeft;
+Decimator<DecimatedMix, MODULATION_OVERSAMPLING> decimatorRight;
+bool decimating = false;
 
 // Dither noise generator state
 uint32_t ditherSeed = 12345;
 
-// Wavetable memory - RAM copy for performance (16-bit unsigned for DAC)
-uint16_t wavetables[WAVEFORM_BANKS][WAVETABLE_SIZE];
-uint16_t currentWavetable[WAVETABLE_SIZE];
+// Snapshots: complete 8-bank sets (wavetables plus per-bank modulation
+// types) resident in RAM. The live one plays and is what the protocol
+// edits; CMD_SNAPSHOT switches between them. Edited by the serial
+// protocol on core1; saved to and loaded from the preset store.
+#define SNAPSHOT_COUNT 4
+
+struct Snapshot {
+  uint16_t wavetables[WAVEFORM_BANKS][WAVETABLE_SIZE];  // 16-bit unsigned for DAC
+  uint8_t modulationTypes[WAVEFORM_BANKS];              // Default to wavefolding
+};
+
+Snapshot snapshots[SNAPSHOT_COUNT];
+uint8_t liveSnapshot = 0;
+
+// The live snapshot's data under the names the rest of the sketch uses
+uint16_t (*wavetables)[WAVETABLE_SIZE] = snapshots[0].wavetables;
+uint8_t* bankModulationTypes = snapshots[0].modulationTypes;
+
+// What the audio core plays: mipmaps and modulation types of every bank.
+// Each snapshot keeps its own set, so switching snapshots hands the audio
+// core a different pointer with no rebuild. An edit rebuilds into the
+// spare set, which then replaces the snapshot's set. A new set goes
+// through pendingSet and core0 swaps it in between render blocks, so
+// playback never sees a half-written table.
+struct WavetableSet {
+  uint16_t mipmaps[WAVEFORM_BANKS][MIPMAP_LEVELS][WAVETABLE_SIZE];
+  uint8_t modulationTypes[WAVEFORM_BANKS];
+};
+
+WavetableSet wavetableSets[SNAPSHOT_COUNT + 1];
+WavetableSet* snapshotSets[SNAPSHOT_COUNT];               // Core1: each snapshot's set
+WavetableSet* spareSet = &wavetableSets[SNAPSHOT_COUNT];  // Core1: not playing, free to rebuild
+WavetableSet* volatile playbackSet = &wavetableSets[0];
+WavetableSet* volatile pendingSet = nullptr;  // Set by core1, cleared by core0 on swap
+const uint16_t* currentWavetable = wavetableSets[0].mipmaps[0][0];  // Playback bank at the current mipmap level
+uint8_t mipmapLevel = 0;
 uint8_t currentModulationType = MOD_WAVEFOLDING;  // Current bank's modulation type
 uint8_t currentBank = 0;                          // Bank for real-time editing (controlled by BANK command)
 uint8_t playbackBank = 0;                         // Bank for audio playback (controlled by CV1)
 uint8_t targetBank = 0;
 bool bankChanged = false;
 
-// Binary protocol variables
-uint8_t protocolBuffer[66];  // Max: 1 cmd + 1 param + 64 data bytes
+// CV1 bank modes (set by CMD_BANKMODE on core1, applied by core0 at
+// control rate)
+#define BANK_MODE_DISCRETE 0  // CV1 steps between banks after a 100ms hysteresis
+#define BANK_MODE_MORPH 1     // CV1 crossfades continuously between neighbouring banks
+volatile uint8_t bankMode = BANK_MODE_DISCRETE;
+uint8_t activeBankMode = BANK_MODE_DISCRETE;
+
+// Morph mode plays morphTable: the two banks either side of morphPosition
+// crossfaded at the current mipmap level. It's rebuilt at control rate
+// only when the position, level or wavetable set changes, so the
+// per-sample cost is the same single table read as the discrete mode.
+uint32_t morphPosition = 0;  // Q16 bank position, integer part is the lower bank
+uint16_t morphTable[WAVETABLE_SIZE];
+
+// Bulk transfer: every bank's wavetable then every bank's modulation
+// type, framed as <cmd> <length:2> <payload> <crc16:2> (little endian,
+// CRC over length and payload)
+#define BULK_PAYLOAD_SIZE (WAVEFORM_BANKS * WAVETABLE_SIZE * 2 + WAVEFORM_BANKS)
+#define BULK_FRAME_SIZE (1 + 2 + BULK_PAYLOAD_SIZE + 2)
+
+// Binary protocol variables (parsed on core1)
+uint8_t protocolBuffer[BULK_FRAME_SIZE];  // Max: a complete bulk upload frame
 uint16_t bufferIndex = 0;
-uint8_t expectedBytes = 0;
+uint16_t expectedBytes = 0;
 bool receivingCommand = false;
+const uint32_t FRAME_TIMEOUT_MS = 200;  // Drop a partial frame after this gap
+
+// Rest of a rejected bulk frame still to drop, so its payload isn't parsed
+// as commands; also ends after FRAME_TIMEOUT_MS of silence
+uint32_t discardBytes = 0;
+
+// Preset store: append-only records in the flash filesystem region (set
+// Tools > Flash Size to reserve at least 8KB for FS; Wren doesn't use a
+// filesystem). Each snapshot is STORE_GROUPS records of up to
+// STORE_GROUP_BANKS wavetables; STORE_KEY_MODULATION holds every
+// snapshot's modulation types. Without the region it loads from EEPROM,
+// which holds one set, but can't save: an EEPROM commit would stall the
+// audio core. Retired sectors are erased from core1's idle loop, one
+// slice every STORE_ERASE_PERIOD_MS.
+#define STORE_SECTORS 4
+#define STORE_ERASE_PERIOD_MS 5
+#define STORE_GROUP_BANKS 3
+#define STORE_GROUPS ((WAVEFORM_BANKS + STORE_GROUP_BANKS - 1) / STORE_GROUP_BANKS)
+#define STORE_KEY_MODULATION (SNAPSHOT_COUNT * STORE_GROUPS)
+static_assert(STORE_KEY_MODULATION < FLASH_LOG_MAX_KEYS, "preset store needs more keys than FlashLog has");
+FlashLog presetStore(qspiFlashDevice);
+extern uint8_t _FS_start;
+extern uint8_t _FS_end;
+
+// Work the protocol hands to core0: unison setup touches state the audio
+// path owns. One slot; core1 posts and waits for it.
+enum AudioCoreRequest {
+  REQUEST_NONE = 0,
+  REQUEST_UNISON
+};
+
+volatile uint8_t audioCoreRequest = REQUEST_NONE;
+uint8_t audioCoreRequestArgs[3];
 
 // Protocol command constants
 #define CMD_PING 0x01
@@ -112,6 +241,17 @@ bool receivingCommand = false;
 #define CMD_DUMP 0x04
 #define CMD_REALTIME 0x05
 #define CMD_MODTYPE 0x06  // New: Set modulation type for bank
+#define CMD_UNISON 0x07   // Unison voices, detune and stereo spread
+#define CMD_BULK_UPLOAD 0x08  // All banks and modulation types, CRC framed
+#define CMD_BULK_DUMP 0x09
+#define CMD_SNAPSHOT 0x0A  // Select, copy to or save a snapshot
+#define CMD_BANKMODE 0x0B  // CV1 discrete bank select or morph
+#define CMD_TELEMETRY 0x0C  // Render cost since the last request (TELEMETRY builds)
+
+// CMD_SNAPSHOT operations
+#define SNAPSHOT_SELECT 0x00  // Make it live: plays on the next block, edits go to it
+#define SNAPSHOT_COPY 0x01    // Copy the live snapshot into it
+#define SNAPSHOT_SAVE 0x02    // Write it to the preset store
 
 // Protocol response constants
 #define RESP_PING 0xA1
@@ -119,20 +259,18 @@ bool receivingCommand = false;
 #define RESP_SAVE 0xA3
 #define RESP_DUMP 0xA4
 #define RESP_MODTYPE 0xA6  // New: Modulation type set response
+#define RESP_UNISON 0xA7
+#define RESP_BULK_UPLOAD 0xA8
+#define RESP_BULK_DUMP 0xA9
+#define RESP_SNAPSHOT 0xAA
+#define RESP_BANKMODE 0xAB
+#define RESP_TELEMETRY TELEMETRY_FRAME_TYPE
 #define RESP_ERROR 0xE0
 #define RESP_RANGE 0xE1
+#define RESP_CRC 0xE2  // Bulk frame failed its CRC or length check
 
 // Simple but effective ADC Filter (from ADC_Test success)
-struct ADCFilter {
-  uint16_t filtered;     // Current filtered value (integer for stability)
-  uint16_t lastOutput;   // Last output value
-  uint32_t accumulator;  // Running sum for averaging
-  uint8_t sampleCount;   // Number of samples in accumulator
-  uint16_t deadband;     // Deadband threshold
-};
-
-ADCFilter adcFilters[4];
-const uint8_t AVG_SAMPLES = 16;         // Number of samples to average
+AveragingADCFilter adcFilters[4];
 const uint16_t DEADBAND_THRESHOLD = 3;  // Ignore changes smaller than this
 
 // Bank switching hysteresis
@@ -153,29 +291,23 @@ volatile uint32_t lastSerialActivity = 0;
 void setup() {
   Serial.begin(115200);
 
-  // Initialize EEPROM
+  // Initialize EEPROM (legacy storage, imported once into the preset store)
   EEPROM.begin(EEPROM_SIZE);
+  beginPresetStore();
 
   // Initialize ADC
   analogReadResolution(12);
 
-  // Initialize Gate input
+  // Initialize Gate input - the interrupt runs on this core, next to the renderer
   pinMode(GATE_IN, INPUT);
-
-  i2s.setBitsPerSample(16);
-  i2s.setLSBJFormat();
-
-  if (!i2s.begin(sampleRate)) {
-    Serial.println("Failed to initialize I2S!");
-    while (1)
-      ;
-  }
+  gateCapture.begin(digitalRead(GATE_IN));
+  attachInterrupt(digitalPinToInterrupt(GATE_IN), onGateEdge, CHANGE);
 
 
   // UNCOMMENT THE NEXT LINE TO RESET ALL WAVETABLES TO DEFAULTS
   // clearEEPROM();  // WARNING: This will erase all saved wavetables!
 
-  // Load wavetables from EEPROM
+  // Load wavetables from the preset store (or EEPROM)
   loadAllWavetables();
 
   // Check if all banks are empty and load presets if needed
@@ -191,8 +323,24 @@ void setup() {
     generateDefaultWaves();
   }
 
-  // Set initial wavetable
-  memcpy(currentWavetable, wavetables[playbackBank], WAVETABLE_SIZE * 2);
+  // Snapshots never saved start as copies of the first
+  for (int snapshot = 1; snapshot < SNAPSHOT_COUNT; snapshot++) {
+    if (isSnapshotEmpty(snapshot)) {
+      snapshots[snapshot] = snapshots[0];
+    }
+  }
+
+  // Band-limited copies of every bank of every snapshot, then the initial
+  // wavetable
+  for (int snapshot = 0; snapshot < SNAPSHOT_COUNT; snapshot++) {
+    WavetableSet& set = wavetableSets[snapshot];
+    for (int bank = 0; bank < WAVEFORM_BANKS; bank++) {
+      buildMipmaps(set, snapshots[snapshot], bank);
+    }
+    memcpy(set.modulationTypes, snapshots[snapshot].modulationTypes, WAVEFORM_BANKS);
+    snapshotSets[snapshot] = &set;
+  }
+  selectWavetable();
 
   // Initialize ADC filters
   initializeADCFilters();
@@ -202,76 +350,218 @@ void setup() {
   FastLED.clear();
   FastLED.show();
 
-  // Start Core1 for NeoPixel control
+  // Core1 parks this core while it programs flash (preset store)
+  multicore_lockout_victim_init();
+
+  // Start Core1 for the serial protocol and NeoPixel control
   multicore_launch_core1(core1Task);
+
+#if TELEMETRY
+  telemetry.begin();
+#endif
+
+  // Initialize I2S output last so the first buffers come from loaded wavetables
+  if (!audioOutput.begin(sampleRate, AUDIO_BUFFER_FRAMES, renderAudio)) {
+    Serial.println("Failed to initialize I2S!");
+    while (1)
+      ;
+  }
 }
 
 void loop() {
-  // Handle serial commands
-  handleSerialProtocol();
+  // Voice setup requested by the serial protocol on core1
+  handleAudioCoreRequest();
+
+  // Renders whenever a DMA buffer is free, returns immediately otherwise
+  audioOutput.update();
+}
+
+void handleAudioCoreRequest() {
+  switch (audioCoreRequest) {
+    case REQUEST_NONE:
+      return;
+
+    case REQUEST_UNISON:
+      configureUnison(audioCoreRequestArgs[0], audioCoreRequestArgs[1], audioCoreRequestArgs[2]);
+      break;
+  }
+
+  __dmb();
+  audioCoreRequest = REQUEST_NONE;
+}
+
+// GPIO interrupt on both gate edges: level and time only, no DSP
+void onGateEdge() {
+  gateCapture.recordEdge(digitalRead(GATE_IN), micros());
+}
+
+// AudioOutput render callback - one DMA buffer of stereo samples
+void renderAudio(int16_t* left, int16_t* right, size_t frames) {
+#if TELEMETRY
+  uint32_t startCycles = cycleCount();
+#endif
+
+  // Wavetable edits from core1 take effect on a block boundary
+  WavetableSet* next = pendingSet;
+  if (next) {
+    playbackSet = next;
+    selectWavetable();
+    __dmb();
+    pendingSet = nullptr;
+  }
 
+  // Hard sync edges that fall in this buffer on the sample clock, at their offsets
+  gateCapture.beginBlock(audioOutput.getBlockMicros(), frames, sampleRate);
+  int syncOffset;
+  bool syncPending = gateCapture.nextRisingEdge(syncOffset);
+
+  for (size_t i = 0; i < frames; i++) {
+    while (syncPending && syncOffset <= (int)i) {
+      // Hard Sync - reset all oscillator phases on the edge's sample
+      for (uint8_t v = 0; v < UNISON_MAX_VOICES; v++) {
+        voicePhase[v] = 0;
+      }
+      syncPending = gateCapture.nextRisingEdge(syncOffset);
+    }
+    renderFrame(left[i], right[i]);
+  }
+
+#if TELEMETRY
+  telemetry.recordBlock(currentModulationType, cycleCount() - startCycles, frames);
+#endif
+}
+
+void renderFrame(int16_t& left, int16_t& right) {
   // Read CV inputs every 16 samples (K102E-style high frequency)
   static int sampleCount = 0;
   if (sampleCount % 16 == 0) {
+#if TELEMETRY
+    uint32_t controlStart = cycleCount();
     updateParameters();
+    telemetry.recordControlLatency(cycleCount() - controlStart);
+#else
+    updateParameters();
+#endif
   }
 
   // Handle bank switching
   if (bankChanged) {
-    memcpy(currentWavetable, wavetables[playbackBank], WAVETABLE_SIZE * 2);
+    selectWavetable();
     bankChanged = false;
   }
 
   // Always ensure current modulation type matches playback bank
-  currentModulationType = bankModulationTypes[playbackBank];
-
-  // Generate wavetable sample
-  float tablePos = phase * WAVETABLE_SIZE;
-  int index = (int)tablePos;
-  float frac = tablePos - index;
-
-  // Linear interpolation between samples (16-bit unsigned values)
-  uint16_t sample1 = currentWavetable[index % WAVETABLE_SIZE];
-  uint16_t sample2 = currentWavetable[(index + 1) % WAVETABLE_SIZE];
-
-  float sampleFloat = sample1 + frac * (sample2 - sample1);
-  sampleFloat = ((sampleFloat - 32768.0) / 32768.0);  // Convert 0-65535 to -1.0 to 1.0
+  currentModulationType = playbackSet->modulationTypes[playbackBank];
+  const bool modulate = smoothedWavefoldAmount > 0.0f;
+
+  VoiceMix mixLeft = 0;
+  VoiceMix mixRight = 0;
+  if (MODULATION_OVERSAMPLING > 1 && (OVERSAMPLED_MODULATION & (1 << currentModulationType))) {
+    if (!decimating) {
+      decimatorLeft.reset();
+      decimatorRight.reset();
+      decimating = true;
+    }
 
-  // Apply current modulation type
-  if (smoothedWavefoldAmount > 0.0) {
-    sampleFloat = applyModulation(sampleFloat, currentModulationType, smoothedWavefoldAmount);
+    DecimatedMix subLeft[MODULATION_OVERSAMPLING];
+    DecimatedMix subRight[MODULATION_OVERSAMPLING];
+    for (int step = 0; step < MODULATION_OVERSAMPLING; step++) {
+      VoiceMix stepLeft = 0;
+      VoiceMix stepRight = 0;
+      mixVoices(step, MODULATION_OVERSAMPLING, modulate, stepLeft, stepRight);
+#if FIXED_POINT_DSP
+      subLeft[step] = (DecimatedMix)(stepLeft >> 2);
+      subRight[step] = (DecimatedMix)(stepRight >> 2);
+#else
+      subLeft[step] = stepLeft;
+      subRight[step] = stepRight;
+#endif
+    }
+#if FIXED_POINT_DSP
+    mixLeft = (VoiceMix)decimatorLeft.process(subLeft) * 4;
+    mixRight = (VoiceMix)decimatorRight.process(subRight) * 4;
+#else
+    mixLeft = decimatorLeft.process(subLeft);
+    mixRight = decimatorRight.process(subRight);
+#endif
+  } else {
+    decimating = false;
+    mixVoices(0, 1, modulate, mixLeft, mixRight);
   }
-
-  // Apply anti-aliasing filter to reduce high-frequency content
-  sampleFloat = applyAntiAliasing(sampleFloat);
-
-  // Add dither noise to reduce quantization noise
-  sampleFloat += generateDither();
+  advanceVoices();
+
+#if FIXED_POINT_DSP
+  // Dither in Q31, then truncate to the Q15 (full-scale) output
+  q31_t dither = generateDitherQ31();
+  left = saturateQ15((int32_t)((mixLeft + dither) >> 16));
+  right = saturateQ15((int32_t)((mixRight + dither) >> 16));
+#else
+  // Add dither noise to reduce quantization noise, the same on both
+  // channels so a centred mono patch stays identical left and right
+  float dither = generateDither();
 
   // Clamp to valid range before conversion
-  sampleFloat = constrain(sampleFloat, -1.0, 1.0);
-
-  int16_t sample = (int16_t)(sampleFloat * amplitude);
+  left = (int16_t)(constrain(mixLeft + dither, -1.0f, 1.0f) * amplitude);
+  right = (int16_t)(constrain(mixRight + dither, -1.0f, 1.0f) * amplitude);
+#endif
 
-  // Write to I2S
-  i2s.write(sample);
-  i2s.write(sample);
+  sampleCount++;
+}
 
-  // Update phase
-  phase += frequency / sampleRate;
-  if (phase >= 1.0) phase -= 1.0;
+// Adds every unison voice, modulated, to the mix at sub-step `step` of
+// `steps` between this output sample and the next. Phases stay put until
+// advanceVoices().
+void mixVoices(int step, int steps, bool modulate, VoiceMix& mixLeft, VoiceMix& mixRight) {
+#if FIXED_POINT_DSP
+  for (uint8_t v = 0; v < unisonVoices; v++) {
+    q15_t sampleQ15 = oscillatorSampleQ15(currentWavetable, voicePhase[v], voiceIncrement[v], step, steps, modulate,
+                                          currentModulationType, smoothedWavefoldAmount, modParams);
+    mixLeft += (int64_t)sampleQ15 * voiceGainLeft[v];
+    mixRight += (int64_t)sampleQ15 * voiceGainRight[v];
+  }
+#else
+  for (uint8_t v = 0; v < unisonVoices; v++) {
+    float sampleFloat = oscillatorSample(currentWavetable, voicePhase[v], voiceIncrement[v], step, steps, modulate,
+                                         currentModulationType, smoothedWavefoldAmount, modParams);
+    mixLeft += sampleFloat * voiceGainLeft[v];
+    mixRight += sampleFloat * voiceGainRight[v];
+  }
+#endif
+}
 
-  sampleCount++;
+// Moves every voice on by one output sample (increments precomputed at
+// control rate)
+void advanceVoices() {
+  for (uint8_t v = 0; v < unisonVoices; v++) {
+    voicePhase[v] = advanceOscillatorPhase(voicePhase[v], voiceIncrement[v]);
+  }
 }
 
+// Core1: called from core1Task(). Bytes are consumed one at a time as they
+// arrive, so a bulk frame spread over many USB packets never blocks.
 void handleSerialProtocol() {
+  // A frame that stopped arriving part-way would swallow the next command
+  if (receivingCommand && millis() - lastSerialActivity > FRAME_TIMEOUT_MS) {
+    receivingCommand = false;
+    bufferIndex = 0;
+    Serial.write(RESP_ERROR);
+  }
+  if (discardBytes && millis() - lastSerialActivity > FRAME_TIMEOUT_MS) {
+    discardBytes = 0;
+  }
+
   while (Serial.available()) {
     uint8_t data = Serial.read();
     lastSerialActivity = millis();  // Update serial activity
 
+    if (discardBytes) {
+      discardBytes--;
+      continue;
+    }
+
     if (!receivingCommand) {
       // Start of new command
-      if (data >= CMD_PING && data <= CMD_MODTYPE) {
+      if (data >= CMD_PING && data <= CMD_TELEMETRY) {
         protocolBuffer[0] = data;
         bufferIndex = 1;
         receivingCommand = true;
@@ -279,6 +569,8 @@ void handleSerialProtocol() {
         // Determine expected bytes for this command
         switch (data) {
           case CMD_PING:
+          case CMD_BULK_DUMP:
+          case CMD_TELEMETRY:
             expectedBytes = 1;  // Just the command
             break;
           case CMD_BANK:
@@ -286,12 +578,24 @@ void handleSerialProtocol() {
           case CMD_DUMP:
             expectedBytes = 2;  // Command + bank parameter
             break;
+          case CMD_BANKMODE:
+            expectedBytes = 2;  // Command + mode
+            break;
           case CMD_MODTYPE:
             expectedBytes = 3;  // Command + bank + modulation type
             break;
+          case CMD_SNAPSHOT:
+            expectedBytes = 3;  // Command + operation + snapshot
+            break;
+          case CMD_UNISON:
+            expectedBytes = 4;  // Command + voices + detune + spread
+            break;
           case CMD_REALTIME:
             expectedBytes = 65;  // Command + 64 bytes data
             break;
+          case CMD_BULK_UPLOAD:
+            expectedBytes = 3;  // Command + length, then the rest of the frame
+            break;
         }
       } else {
         // Invalid command - send error
@@ -301,14 +605,29 @@ void handleSerialProtocol() {
       // Continue receiving command data
       protocolBuffer[bufferIndex++] = data;
 
-      // Check if we have received the complete command
-      if (bufferIndex >= expectedBytes) {
-        handleBinaryCommand();
-        bufferIndex = 0;
-        expectedBytes = 0;
-        receivingCommand = false;
+      // Bulk upload: the length field decides how much more follows
+      if (protocolBuffer[0] == CMD_BULK_UPLOAD && bufferIndex == 3) {
+        uint16_t length = protocolBuffer[1] | (protocolBuffer[2] << 8);
+        if (length != BULK_PAYLOAD_SIZE) {
+          // Drop the declared payload and its CRC before the next command
+          Serial.write(RESP_CRC);
+          receivingCommand = false;
+          bufferIndex = 0;
+          discardBytes = length + 2;
+          continue;
+        }
+        expectedBytes = BULK_FRAME_SIZE;
       }
     }
+
+    // Check if we have received the complete command (one-byte commands
+    // complete on their first byte)
+    if (receivingCommand && bufferIndex >= expectedBytes) {
+      handleBinaryCommand();
+      bufferIndex = 0;
+      expectedBytes = 0;
+      receivingCommand = false;
+    }
   }
 }
 
@@ -338,9 +657,10 @@ void handleBinaryCommand() {
         if (bankNumber >= WAVEFORM_BANKS) {
           Serial.write(RESP_RANGE);
         } else {
-          saveWavetable(bankNumber);
-          saveModulationSettings();  // Save all modulation settings when SAVE is called
-          Serial.write(RESP_SAVE);
+          // Flash is programmed from this core, not the audio core; no
+          // preset store (no FS region), no save
+          bool saved = presetStore.isReady() && saveBank(bankNumber);
+          Serial.write(saved ? RESP_SAVE : RESP_ERROR);
         }
         break;
       }
@@ -351,12 +671,11 @@ void handleBinaryCommand() {
         if (bankNumber >= WAVEFORM_BANKS) {
           Serial.write(RESP_RANGE);
         } else {
-          Serial.write(RESP_DUMP);
-          // Send specified bank waveform data
-          for (int i = 0; i < WAVETABLE_SIZE; i++) {
-            Serial.write((uint8_t)(wavetables[bankNumber][i] & 0xFF));
-            Serial.write((uint8_t)((wavetables[bankNumber][i] >> 8) & 0xFF));
-          }
+          // Send specified bank waveform data in one write
+          uint8_t response[1 + WAVETABLE_SIZE * 2];
+          response[0] = RESP_DUMP;
+          packWavetable(bankNumber, response + 1);
+          Serial.write(response, sizeof(response));
         }
         break;
       }
@@ -375,35 +694,221 @@ void handleBinaryCommand() {
           Serial.write(RESP_RANGE);
         } else {
           bankModulationTypes[bankNumber] = modulationType;
-          // If this is the current playback bank, update immediately
-          if (bankNumber == playbackBank) {
-            currentModulationType = modulationType;
-          }
+          // Playback follows on the next block if this bank is playing
+          publishSnapshot(liveSnapshot, 0);
           // Don't save to EEPROM - wait for explicit SAVE command
           Serial.write(RESP_MODTYPE);
         }
         break;
       }
 
+    case CMD_UNISON:
+      {
+        uint8_t voices = protocolBuffer[1];
+
+        if (voices < 1 || voices > UNISON_MAX_VOICES) {
+          Serial.write(RESP_RANGE);
+        } else {
+          // Not saved to EEPROM, like the performance CVs
+          runOnAudioCore(REQUEST_UNISON, voices, protocolBuffer[2], protocolBuffer[3]);
+          Serial.write(RESP_UNISON);
+        }
+        break;
+      }
+
+    case CMD_BANKMODE:
+      if (protocolBuffer[1] > BANK_MODE_MORPH) {
+        Serial.write(RESP_RANGE);
+      } else {
+        // Not saved, like the performance CVs
+        bankMode = protocolBuffer[1];
+        Serial.write(RESP_BANKMODE);
+      }
+      break;
+
+    case CMD_BULK_UPLOAD:
+      processBulkUpload();
+      break;
+
+    case CMD_BULK_DUMP:
+      sendBulkDump();
+      break;
+
+    case CMD_TELEMETRY:
+#if TELEMETRY
+      sendTelemetry();
+#else
+      Serial.write(RESP_ERROR);
+#endif
+      break;
+
+    case CMD_SNAPSHOT:
+      {
+        uint8_t operation = protocolBuffer[1];
+        uint8_t snapshot = protocolBuffer[2];
+
+        if (snapshot >= SNAPSHOT_COUNT || operation > SNAPSHOT_SAVE) {
+          Serial.write(RESP_RANGE);
+        } else if (operation == SNAPSHOT_SELECT) {
+          selectSnapshot(snapshot);
+          Serial.write(RESP_SNAPSHOT);
+        } else if (operation == SNAPSHOT_COPY) {
+          snapshots[snapshot] = snapshots[liveSnapshot];
+          publishSnapshot(snapshot, 0xFF);
+          Serial.write(RESP_SNAPSHOT);
+        } else {
+          // EEPROM fallback only holds the set SAVE writes
+          bool saved = presetStore.isReady() && saveSnapshot(snapshot);
+          Serial.write(saved ? RESP_SNAPSHOT : RESP_ERROR);
+        }
+        break;
+      }
+
     default:
       Serial.write(RESP_ERROR);
       break;
   }
 }
 
-void processRealtimeWaveform() {
-  // Convert 64 bytes to 32 uint16_t samples (little endian)
-  // Data starts at protocolBuffer[1] (after command byte)
+// Core1: post a request to loop() on core0 and wait until it has run
+void runOnAudioCore(uint8_t request, uint8_t arg0, uint8_t arg1, uint8_t arg2) {
+  audioCoreRequestArgs[0] = arg0;
+  audioCoreRequestArgs[1] = arg1;
+  audioCoreRequestArgs[2] = arg2;
+  __dmb();
+  audioCoreRequest = request;
+
+  while (audioCoreRequest != REQUEST_NONE) {
+    tight_loop_contents();
+  }
+}
+
+// Core1: rebuild the banks in `bankMask` of `snapshot` into the spare
+// set, copy the others and the modulation types, and make it the
+// snapshot's set. If the snapshot is live, hand it to the audio core. The
+// set it replaces becomes the spare; nothing is written until the
+// previous hand-off was taken, so that's never a set still playing.
+void publishSnapshot(uint8_t snapshot, uint8_t bankMask) {
+  while (pendingSet != nullptr) {
+    tight_loop_contents();
+  }
+
+  WavetableSet* current = snapshotSets[snapshot];
+  WavetableSet* staging = spareSet;
+
+  for (uint8_t bank = 0; bank < WAVEFORM_BANKS; bank++) {
+    if (bankMask & (1 << bank)) {
+      buildMipmaps(*staging, snapshots[snapshot], bank);
+    } else {
+      memcpy(staging->mipmaps[bank], current->mipmaps[bank], sizeof(staging->mipmaps[bank]));
+    }
+  }
+  memcpy(staging->modulationTypes, snapshots[snapshot].modulationTypes, WAVEFORM_BANKS);
+
+  snapshotSets[snapshot] = staging;
+  spareSet = current;
+
+  if (snapshot == liveSnapshot) {
+    __dmb();
+    pendingSet = staging;
+  }
+}
+
+// Core1: make `snapshot` live. Its mipmaps are already built, so the
+// audio core just swaps pointers on the next block.
+void selectSnapshot(uint8_t snapshot) {
+  while (pendingSet != nullptr) {
+    tight_loop_contents();
+  }
+
+  liveSnapshot = snapshot;
+  wavetables = snapshots[snapshot].wavetables;
+  bankModulationTypes = snapshots[snapshot].modulationTypes;
+
+  __dmb();
+  pendingSet = snapshotSets[snapshot];
+}
+
+// 32 samples, little endian, as sent by DUMP and the bulk frames
+void packWavetable(uint8_t bank, uint8_t* out) {
   for (int i = 0; i < WAVETABLE_SIZE; i++) {
-    uint8_t lowByte = protocolBuffer[1 + i * 2];
-    uint8_t highByte = protocolBuffer[1 + i * 2 + 1];
-    wavetables[currentBank][i] = (uint16_t)(lowByte | (highByte << 8));
+    out[i * 2] = (uint8_t)(wavetables[bank][i] & 0xFF);
+    out[i * 2 + 1] = (uint8_t)((wavetables[bank][i] >> 8) & 0xFF);
+  }
+}
+
+void unpackWavetable(uint8_t bank, const uint8_t* in) {
+  for (int i = 0; i < WAVETABLE_SIZE; i++) {
+    wavetables[bank][i] = (uint16_t)(in[i * 2] | (in[i * 2 + 1] << 8));
+  }
+}
+
+void processBulkUpload() {
+  const uint8_t* payload = protocolBuffer + 3;
+  uint16_t received = protocolBuffer[3 + BULK_PAYLOAD_SIZE] | (protocolBuffer[4 + BULK_PAYLOAD_SIZE] << 8);
+
+  if (crc16(protocolBuffer + 1, 2 + BULK_PAYLOAD_SIZE) != received) {
+    Serial.write(RESP_CRC);
+    return;
+  }
+
+  const uint8_t* modulationTypes = payload + WAVEFORM_BANKS * WAVETABLE_SIZE * 2;
+  for (int bank = 0; bank < WAVEFORM_BANKS; bank++) {
+    if (modulationTypes[bank] >= NUM_MODULATION_TYPES) {
+      Serial.write(RESP_RANGE);
+      return;
+    }
+  }
+
+  // Like REALTIME: RAM only until SAVE
+  for (uint8_t bank = 0; bank < WAVEFORM_BANKS; bank++) {
+    unpackWavetable(bank, payload + bank * WAVETABLE_SIZE * 2);
+    bankModulationTypes[bank] = modulationTypes[bank];
+  }
+  publishSnapshot(liveSnapshot, 0xFF);
+
+  Serial.write(RESP_BULK_UPLOAD);
+}
+
+void sendBulkDump() {
+  // Reuses the receive buffer: the parser is idle while a command runs
+  uint8_t* frame = protocolBuffer;
+  frame[0] = RESP_BULK_DUMP;
+  frame[1] = BULK_PAYLOAD_SIZE & 0xFF;
+  frame[2] = BULK_PAYLOAD_SIZE >> 8;
+
+  uint8_t* payload = frame + 3;
+  for (uint8_t bank = 0; bank < WAVEFORM_BANKS; bank++) {
+    packWavetable(bank, payload + bank * WAVETABLE_SIZE * 2);
   }
+  memcpy(payload + WAVEFORM_BANKS * WAVETABLE_SIZE * 2, bankModulationTypes, WAVEFORM_BANKS);
+
+  uint16_t crc = crc16(frame + 1, 2 + BULK_PAYLOAD_SIZE);
+  frame[3 + BULK_PAYLOAD_SIZE] = crc & 0xFF;
+  frame[4 + BULK_PAYLOAD_SIZE] = crc >> 8;
 
-  // Only update playback if editing the same bank that's currently playing
-  if (currentBank == playbackBank) {
-    memcpy(currentWavetable, wavetables[currentBank], WAVETABLE_SIZE * 2);
+  Serial.write(frame, BULK_FRAME_SIZE);
+}
+
+#if TELEMETRY
+// Core1: the interval since the last request, taken after the audio
+// core's next block (at most one DMA buffer away)
+void sendTelemetry() {
+  uint8_t frame[telemetry.frameSize];
+  while (!telemetry.poll(frame, audioOutput.getUnderruns(), sampleRate, rp2040.f_cpu())) {
+    tight_loop_contents();
   }
+  Serial.write(frame, sizeof(frame));
+}
+#endif
+
+void processRealtimeWaveform() {
+  // Convert 64 bytes to 32 uint16_t samples (little endian)
+  // Data starts at protocolBuffer[1] (after command byte)
+  unpackWavetable(currentBank, protocolBuffer + 1);
+
+  // Playback follows on the next block when this is the bank that's playing
+  publishSnapshot(liveSnapshot, 1 << currentBank);
 }
 
 void updateParameters() {
@@ -424,54 +929,218 @@ void updateParameters() {
   uint16_t cv1 = adcFilters[2].filtered;
   uint16_t cv2 = adcFilters[3].filtered;
 
-  gateState = digitalRead(GATE_IN);
-
-  // Hard Sync - Reset phase on rising edge
-  if (gateState && !lastGateState) {
-    phase = 0.0;  // Reset oscillator phase
-  }
-  lastGateState = gateState;
-
-  // Calculate frequency with calibrated ranges
-  // Use floating point math throughout for better precision
-  float adcVoltage = ((float)(PITCH_CV_MAX - pitchCV) / (float)PITCH_CV_MAX) * 3.3;
-  float knobVoltage = ((float)(pitchKnob - PITCH_KNOB_MIN) / (float)(PITCH_KNOB_MAX - PITCH_KNOB_MIN)) * 3.3;
-  knobVoltage = constrain(knobVoltage, 0.0, 3.3);
-
-  // Convert to actual CV voltage (0-5V range)
-  float actualCV = (adcVoltage - 1.65) / 0.33;
-  actualCV = constrain(actualCV, 0.0, 5.0);
-
-  // 1V/octave standard
-  float cvOctaves = actualCV;
-  float knobOctaves = (knobVoltage - 1.65) / 1.65;
+  // Calculate frequency with calibrated ranges (1V/octave standard)
+  float cvOctaves = pitchCvVolts(pitchCV);
+  float knobOctaves = pitchKnobOctaves(pitchKnob);
 
   // Calculate frequency with exponential smoothing for stability
-  float targetFrequency = 440.0 * pow(2.0, cvOctaves + knobOctaves - 2.0);
-  targetFrequency = constrain(targetFrequency, 20.0, 8000.0);
+  float targetFrequency = octavesToFrequency(cvOctaves + knobOctaves - 2.0f);
+  targetFrequency = constrain(targetFrequency, 20.0f, 8000.0f);
 
   // Smooth frequency changes to reduce jitter
-  frequency = frequency * 0.99 + targetFrequency * 0.01;
+  frequency = frequency * 0.99f + targetFrequency * 0.01f;
+  updateVoiceIncrements();
+
+  // Highest mipmap level whose top harmonic stays below Nyquist for the
+  // highest detuned voice
+  uint8_t level = selectMipmapLevel(frequency * maxDetuneRatio, sampleRate);
+  if (level != mipmapLevel) {
+    mipmapLevel = level;
+    selectWavetable();
+  }
 
-  // CV1: Bank selection with hysteresis
+  // CV1: Bank selection with hysteresis, or morph position
   updateBankSelection(cv1);
 
   // CV2: Wavefolding amount (0-100%)
-  wavefoldAmount = map(cv2, CV2_MIN, CV2_MAX, 0, 100) / 100.0;
-  wavefoldAmount = constrain(wavefoldAmount, 0.0, 1.0);
+  wavefoldAmount = map(cv2, CV2_MIN, CV2_MAX, 0, 100) / 100.0f;
+  wavefoldAmount = constrain(wavefoldAmount, 0.0f, 1.0f);
 
   // Smooth the wavefold amount for stable modulation
-  smoothedWavefoldAmount = smoothedWavefoldAmount * 0.95 + wavefoldAmount * 0.05;
+  smoothedWavefoldAmount = smoothedWavefoldAmount * 0.95f + wavefoldAmount * 0.05f;
+  updateModulationParams(modParams, smoothedWavefoldAmount);
 
   // Update display bank for NeoPixel
   displayBank = playbackBank;
 }
 
+void updateVoiceIncrements() {
+  for (uint8_t v = 0; v < unisonVoices; v++) {
+#if FIXED_POINT_DSP
+    voiceIncrement[v] = phaseIncrement(frequency * voiceDetuneRatio[v], sampleRate);
+#else
+    voiceIncrement[v] = frequency * voiceDetuneRatio[v] * (1.0f / sampleRate);
+#endif
+  }
+}
+
+// Spreads the voices evenly from -1 (lowest, left) to +1 (highest, right):
+// detune up to UNISON_MAX_DETUNE_CENTS, pan up to hard left/right. The mix
+// is scaled by 1/sqrt(voices) so the detuned sum keeps about one voice's
+// loudness; a single voice stays at unity gain.
+void configureUnison(uint8_t voices, uint8_t detune, uint8_t spread) {
+  float detuneCents = detune * (UNISON_MAX_DETUNE_CENTS / 255.0f);
+  float width = spread * (1.0f / 255.0f);
+  float norm = 1.0f / sqrtf((float)voices);
+
+  maxDetuneRatio = 1.0f;
+  for (uint8_t v = 0; v < voices; v++) {
+    float position = (voices > 1) ? 2.0f * v / (voices - 1) - 1.0f : 0.0f;
+    float pan = position * width;
+
+    voiceDetuneRatio[v] = exp2f(position * detuneCents * (1.0f / 1200.0f));
+    maxDetuneRatio = max(maxDetuneRatio, voiceDetuneRatio[v]);
+
+    float gainLeft = norm * min(1.0f, 1.0f - pan);
+    float gainRight = norm * min(1.0f, 1.0f + pan);
+#if FIXED_POINT_DSP
+    voiceGainLeft[v] = (int32_t)(gainLeft * 65536.0f + 0.5f);
+    voiceGainRight[v] = (int32_t)(gainRight * 65536.0f + 0.5f);
+#else
+    voiceGainLeft[v] = gainLeft;
+    voiceGainRight[v] = gainRight;
+#endif
+
+    // Newly added voices start at golden-ratio phase offsets so they
+    // don't begin in unison; running voices keep their phase
+    if (v >= unisonVoices) {
+#if FIXED_POINT_DSP
+      voicePhase[v] = (uint32_t)v * 0x9E3779B9u;
+#else
+      float startPhase = v * 0.618034f;
+      voicePhase[v] = startPhase - floorf(startPhase);
+#endif
+    }
+  }
+
+  unisonDetune = detune;
+  unisonSpread = spread;
+  unisonVoices = voices;
+  updateVoiceIncrements();
+}
+
+void beginPresetStore() {
+  uint32_t regionSize = &_FS_end - &_FS_start;
+  uint32_t sectors = min((uint32_t)STORE_SECTORS, regionSize / FLASH_LOG_SECTOR_SIZE);
+  presetStore.begin((uint32_t)((uintptr_t)&_FS_start - XIP_BASE), sectors);
+}
+
 void loadAllWavetables() {
+  // begin() already scanned the log; these are lookups in its index
+  if (presetStore.isReady() && !presetStore.isEmpty()) {
+    for (int snapshot = 0; snapshot < SNAPSHOT_COUNT; snapshot++) {
+      loadSnapshot(snapshot);
+    }
+    return;
+  }
+
+  // EEPROM layout: the storage when there is no flash region, and the
+  // source of a one-time import into an empty preset store
   for (int bank = 0; bank < WAVEFORM_BANKS; bank++) {
     loadWavetable(bank);
   }
   loadModulationSettings();
+
+  if (presetStore.isReady()) {
+    for (int bank = 0; bank < WAVEFORM_BANKS; bank++) {
+      if (!isWavetableEmpty(bank)) {
+        saveAllBanks();
+        break;
+      }
+    }
+  }
+}
+
+uint8_t storeKey(uint8_t snapshot, uint8_t group) {
+  return snapshot * STORE_GROUPS + group;
+}
+
+uint8_t storeGroupBanks(uint8_t group) {
+  return min(STORE_GROUP_BANKS, WAVEFORM_BANKS - group * STORE_GROUP_BANKS);
+}
+
+// Missing records leave the snapshot's banks empty
+void loadSnapshot(uint8_t snapshot) {
+  Snapshot& target = snapshots[snapshot];
+
+  for (uint8_t group = 0; group < STORE_GROUPS; group++) {
+    uint16_t* first = target.wavetables[group * STORE_GROUP_BANKS];
+    uint16_t size = storeGroupBanks(group) * sizeof(target.wavetables[0]);
+
+    uint16_t length;
+    const uint8_t* data = presetStore.find(storeKey(snapshot, group), &length);
+    if (data && length == size) {
+      memcpy(first, data, size);
+    } else {
+      memset(first, 0, size);
+    }
+  }
+
+  uint16_t length;
+  const uint8_t* types = presetStore.find(STORE_KEY_MODULATION, &length);
+  bool found = types && length == SNAPSHOT_COUNT * WAVEFORM_BANKS;
+  for (int bank = 0; bank < WAVEFORM_BANKS; bank++) {
+    uint8_t type = found ? types[snapshot * WAVEFORM_BANKS + bank] : MOD_WAVEFOLDING;
+    target.modulationTypes[bank] = (type < NUM_MODULATION_TYPES) ? type : MOD_WAVEFOLDING;
+  }
+}
+
+// Store the modulation types of `snapshot`; the other snapshots keep
+// what is stored for them, not their unsaved edits
+bool saveModulationTypes(uint8_t snapshot) {
+  uint8_t types[SNAPSHOT_COUNT][WAVEFORM_BANKS];
+
+  uint16_t length;
+  const uint8_t* stored = presetStore.find(STORE_KEY_MODULATION, &length);
+  for (int s = 0; s < SNAPSHOT_COUNT; s++) {
+    const uint8_t* source = (stored && length == sizeof(types)) ? stored + s * WAVEFORM_BANKS : snapshots[s].modulationTypes;
+    memcpy(types[s], source, WAVEFORM_BANKS);
+  }
+  memcpy(types[snapshot], snapshots[snapshot].modulationTypes, WAVEFORM_BANKS);
+
+  return presetStore.write(STORE_KEY_MODULATION, types, sizeof(types));
+}
+
+// One bank of the live snapshot and its modulation types to the preset
+// store. The bank's record is merged with what is stored, so its
+// neighbours' unsaved edits stay unsaved; records that match what is
+// stored are skipped, so only changed data is written.
+bool saveBank(uint8_t bank) {
+  uint8_t group = bank / STORE_GROUP_BANKS;
+  uint8_t first = group * STORE_GROUP_BANKS;
+  uint16_t size = storeGroupBanks(group) * sizeof(wavetables[0]);
+  uint8_t key = storeKey(liveSnapshot, group);
+
+  uint16_t record[STORE_GROUP_BANKS][WAVETABLE_SIZE];
+  uint16_t length;
+  const uint8_t* stored = presetStore.find(key, &length);
+  memcpy(record, (stored && length == size) ? stored : (const uint8_t*)wavetables[first], size);
+  memcpy(record[bank - first], wavetables[bank], sizeof(wavetables[bank]));
+
+  bool ok = presetStore.write(key, record, size);
+  return saveModulationTypes(liveSnapshot) && ok;
+}
+
+bool saveSnapshot(uint8_t snapshot) {
+  bool ok = true;
+  for (uint8_t group = 0; group < STORE_GROUPS; group++) {
+    const uint16_t* first = snapshots[snapshot].wavetables[group * STORE_GROUP_BANKS];
+    ok = presetStore.write(storeKey(snapshot, group), first, storeGroupBanks(group) * sizeof(snapshots[0].wavetables[0])) && ok;
+  }
+  return saveModulationTypes(snapshot) && ok;
+}
+
+// The live snapshot, or the EEPROM set without a preset store
+void saveAllBanks() {
+  if (presetStore.isReady()) {
+    saveSnapshot(liveSnapshot);
+    return;
+  }
+
+  for (int bank = 0; bank < WAVEFORM_BANKS; bank++) {
+    saveWavetable(bank);
+  }
+  saveModulationSettings();
 }
 
 void loadWavetable(uint8_t bank) {
@@ -521,6 +1190,47 @@ void saveModulationSettings() {
 }
 
 
+// Point playback at the current bank and mipmap level, or at the
+// morphed table rebuilt for them
+void selectWavetable() {
+  if (activeBankMode == BANK_MODE_MORPH) {
+    updateMorphTable();
+    currentWavetable = morphTable;
+  } else {
+    currentWavetable = playbackSet->mipmaps[playbackBank][mipmapLevel];
+  }
+}
+
+// Crossfade the banks either side of morphPosition into morphTable
+void updateMorphTable() {
+  uint8_t lower = morphPosition >> 16;
+  uint8_t upper = (lower < WAVEFORM_BANKS - 1) ? lower + 1 : lower;
+  int32_t weight = (morphPosition & 0xFFFF) >> 1;  // Q15
+
+  const uint16_t* a = playbackSet->mipmaps[lower][mipmapLevel];
+  const uint16_t* b = playbackSet->mipmaps[upper][mipmapLevel];
+  for (int i = 0; i < WAVETABLE_SIZE; i++) {
+    // Full-scale difference times a Q15 weight still fits in 32 bits
+    int32_t difference = (int32_t)b[i] - a[i];
+    morphTable[i] = (uint16_t)(a[i] + ((difference * weight) >> 15));
+  }
+}
+
+// Rebuild the band-limited copies of one bank of `set` from `snapshot`
+void buildMipmaps(WavetableSet& set, const Snapshot& snapshot, uint8_t bank) {
+  if (bank >= WAVEFORM_BANKS) return;
+  buildMipmapLevels(snapshot.wavetables[bank], set.mipmaps[bank]);
+}
+
+bool isSnapshotEmpty(uint8_t snapshot) {
+  for (int bank = 0; bank < WAVEFORM_BANKS; bank++) {
+    for (int i = 0; i < WAVETABLE_SIZE; i++) {
+      if (snapshots[snapshot].wavetables[bank][i] != 0) return false;
+    }
+  }
+  return true;
+}
+
 bool isWavetableEmpty(uint8_t bank) {
   for (int i = 0; i < WAVETABLE_SIZE; i++) {
     if (wavetables[bank][i] != 0) return false;
@@ -534,6 +1244,11 @@ void clearEEPROM() {
     EEPROM.write(i, 0);
   }
   EEPROM.commit();
+
+  // And the preset store, or the next boot would load it again
+  if (presetStore.isReady()) {
+    presetStore.format();
+  }
 }
 
 void generateDefaultWaves() {
@@ -542,123 +1257,11 @@ void generateDefaultWaves() {
     for (int i = 0; i < WAVETABLE_SIZE; i++) {
       wavetables[bank][i] = pgm_read_word(&preset_waveforms[bank][i]);
     }
-    // Save each preset to EEPROM
-    saveWavetable(bank);
     // Set default modulation (wavefolding)
     bankModulationTypes[bank] = MOD_WAVEFOLDING;
   }
-  // Save default modulation settings
-  saveModulationSettings();
-}
-
-// Modulation Functions
-
-// Original wavefolding function
-float applyWavefolding(float input, float amount) {
-  if (amount <= 0.0) return input;
-
-  // Scale input by fold amount (more folding = higher gain)
-  float scaled = input * (1.0 + amount * 4.0);
-
-  // Apply multiple folding stages
-  float folded = scaled;
-
-  // Triangle wave folding - reflects signal when it exceeds ±1.0
-  while (folded > 1.0) {
-    folded = 2.0 - folded;
-  }
-  while (folded < -1.0) {
-    folded = -2.0 - folded;
-  }
-
-  // Mix between original and folded signal
-  return input * (1.0 - amount) + folded * amount;
-}
-
-// Overflow modulation - let signal wrap around instead of clipping
-float applyOverflow(float input, float amount) {
-  if (amount <= 0.0) return input;
-
-  // Scale input to increase overflow probability
-  float scaled = input * (1.0 + amount * 3.0);
-
-  // Wrap around at ±1.0 boundaries
-  while (scaled > 1.0) scaled -= 2.0;
-  while (scaled < -1.0) scaled += 2.0;
-
-  // Mix between original and overflowed signal
-  return input * (1.0 - amount) + scaled * amount;
-}
-
-// Bitcrush modulation - reduce bit depth for digital distortion
-float applyBitcrush(float input, float amount) {
-  if (amount <= 0.0) return input;
-  float stepSize = (amount * 0.99);  // 0.5001 down to 0.0001
-
-  // Quantize the input to step size
-  float crushed = floor(input / stepSize + 0.5) * stepSize;
-
-  // Clamp to valid range
-  crushed = constrain(crushed, -1.0, 1.0);
-
-  return crushed;
-}
-
-// Phase Distortion modulation - distort wavetable read position
-float applyPhaseDistortion(float input, float amount, float currentPhase) {
-  if (amount <= 0.0) return input;
-
-  // Generate distorted phase using fast sine table
-  float distortedPhase = currentPhase + amount * 0.3 * fastSin(currentPhase);
-
-  // Fast phase wrapping using fractional part
-  distortedPhase = distortedPhase - floor(distortedPhase);
-
-  // Re-sample wavetable at distorted phase position
-  float distortedTablePos = distortedPhase * WAVETABLE_SIZE;
-  int index = (int)distortedTablePos;
-  float frac = distortedTablePos - index;
-
-  // Use bitwise AND for faster modulo (WAVETABLE_SIZE is 32)
-  uint16_t sample1 = currentWavetable[index & 31];
-  uint16_t sample2 = currentWavetable[(index + 1) & 31];
-
-  float distortedSample = sample1 + frac * (sample2 - sample1);
-  distortedSample = -((distortedSample - 32768.0) / 32767.5);
-
-  // Mix between original and phase-distorted signal
-  return input * (1.0 - amount) + distortedSample * amount;
-}
-
-// Resonance modulation - CZ-101 style resonant synthesis
-float applyResonance(float input, float amount, float currentPhase) {
-  if (amount <= 0.0) return input;
-
-  // Resonant frequency ratio (1.0x to 8.0x fundamental)
-  float resonantRatio = 1.0 + amount * 7.0;
-
-  // Generate resonant frequency phase - use fractional part instead of fmod
-  float resonantPhase = (currentPhase * resonantRatio);
-  resonantPhase = resonantPhase - floor(resonantPhase);
-
-  // Generate resonant sine wave using fast table
-  float resonantSine = fastSin(resonantPhase);
-
-  // Window function (fundamental frequency) for amplitude modulation
-  float windowAmp = abs(fastSin(currentPhase));
-
-  // Apply CZ-101 style resonant synthesis
-  float resonantSignal = resonantSine * windowAmp;
-
-  // Mix between original wavetable and resonant signal
-  return input * (1.0 - amount) + resonantSignal * amount;
-}
-
-// Simple 2-pole anti-aliasing low-pass filter
-float applyAntiAliasing(float input) {
-  antiAliasFilter1 = antiAliasFilter1 * AA_CUTOFF + input * (1.0 - AA_CUTOFF);
-  antiAliasFilter2 = antiAliasFilter2 * AA_CUTOFF + antiAliasFilter1 * (1.0 - AA_CUTOFF);
-  return antiAliasFilter2;
+  // Save the presets and default modulation settings
+  saveAllBanks();
 }
 
 // Simple dither noise generator (LFSR)
@@ -667,25 +1270,15 @@ float generateDither() {
   return ((float)(ditherSeed & 0x3) / 4.0f - 0.5f) / 32768.0f;  // ±0.5 LSB dither (proper level)
 }
 
-// Master modulation dispatcher
-float applyModulation(float input, uint8_t modulationType, float amount) {
-  switch (modulationType) {
-    case MOD_WAVEFOLDING:
-      return applyWavefolding(input, amount);
-    case MOD_OVERFLOW:
-      return applyOverflow(input, amount);
-    case MOD_BITCRUSH:
-      return applyBitcrush(input, amount);
-    case MOD_PHASE_DISTORTION:
-      return applyPhaseDistortion(input, amount, phase);
-    case MOD_RESONANCE:
-      return applyResonance(input, amount, phase);
-    default:
-      return input;
-  }
+#if FIXED_POINT_DSP
+// Q31 version of generateDither()
+q31_t generateDitherQ31() {
+  ditherSeed = (ditherSeed >> 1) ^ (-(ditherSeed & 1u) & 0xd0000001u);
+  return ((q31_t)(ditherSeed & 0x3) - 2) << 14;  // Same ±0.5 LSB as generateDither()
 }
+#endif
 
-// Core1 Task for FastLED control
+// Core1 Task for the serial protocol and FastLED control
 void core1Task() {
   // Define colors using CRGB
   CRGB colors[8] = {
@@ -700,10 +1293,22 @@ void core1Task() {
   };
 
   uint32_t lastUpdate = 0;
+  uint32_t lastErase = 0;
 
   while (true) {
+    // Serial protocol runs here, off the audio core
+    handleSerialProtocol();
+
     uint32_t now = millis();
 
+    // Preset store erase, a slice at a time between frames: each parks
+    // core0 for at most FLASH_LOG_ERASE_SLICE_US, which the queued I2S
+    // buffers cover, and the gaps let it render them again
+    if (!receivingCommand && !discardBytes && presetStore.isErasePending() && now - lastErase >= STORE_ERASE_PERIOD_MS) {
+      lastErase = now;
+      presetStore.service();
+    }
+
     // Check if serial is active (within last 3 seconds)
     serialConnected = (now - lastSerialActivity) < 3000;
 
@@ -726,7 +1331,7 @@ void core1Task() {
       FastLED.show();
     }
 
-    delay(5);  // 10ms delay
+    delay(1);  // The USB receive FIFO holds far more than 1ms at 115200 baud
   }
 }
 
@@ -741,46 +1346,28 @@ void initializeADCFilters() {
   };
 
   for (int i = 0; i < 4; i++) {
-    adcFilters[i].filtered = 0;
-    adcFilters[i].lastOutput = 0;
-    adcFilters[i].accumulator = 0;
-    adcFilters[i].sampleCount = 0;
-    adcFilters[i].deadband = deadbands[i];
+    adcFilters[i].begin(deadbands[i]);
   }
 }
 
 void filterADCValues(uint16_t rawValues[4]) {
   for (int i = 0; i < 4; i++) {
     // Simple running average - proven stable in ADC_Test
-    adcFilters[i].accumulator += rawValues[i];
-    adcFilters[i].sampleCount++;
-
-    // Calculate average when we have enough samples
-    if (adcFilters[i].sampleCount >= AVG_SAMPLES) {
-      uint16_t avgValue = adcFilters[i].accumulator / AVG_SAMPLES;
-
-      // Apply deadband - only update if change is significant
-      if (adcFilters[i].filtered == 0) {
-        // Initialize
-        adcFilters[i].filtered = avgValue;
-        adcFilters[i].lastOutput = avgValue;
-      } else {
-        int change = abs((int)avgValue - (int)adcFilters[i].lastOutput);
-        if (change > adcFilters[i].deadband) {
-          adcFilters[i].filtered = avgValue;
-          adcFilters[i].lastOutput = avgValue;
-        }
-        // If within deadband, keep the last output value
-      }
-
-      // Reset accumulator
-      adcFilters[i].accumulator = 0;
-      adcFilters[i].sampleCount = 0;
-    }
+    adcFilters[i].process(rawValues[i]);
   }
 }
 
 void updateBankSelection(uint16_t cv1Value) {
+  if (activeBankMode != bankMode) {
+    activeBankMode = bankMode;
+    bankChanged = true;
+  }
+
+  if (activeBankMode == BANK_MODE_MORPH) {
+    updateMorphPosition(cv1Value);
+    return;
+  }
+
   uint32_t currentTime = millis();
 
   // Map CV1 to bank number using calibrated range
@@ -799,4 +1386,18 @@ void updateBankSelection(uint16_t cv1Value) {
     playbackBank = bankHyst.targetBank;
     bankChanged = true;
   }
-}
\ No newline at end of file
+}
+
+// CV1 across the calibrated range maps to bank 0 through the last bank
+void updateMorphPosition(uint16_t cv1Value) {
+  int32_t offset = constrain((int32_t)cv1Value - CV1_MIN, 0, CV1_MAX - CV1_MIN);
+  uint32_t position = ((uint32_t)offset * ((WAVEFORM_BANKS - 1) << 16)) / (CV1_MAX - CV1_MIN);
+
+  if (position != morphPosition) {
+    morphPosition = position;
+
+    // Modulation type and LED follow the nearer bank
+    playbackBank = (position + 0x8000) >> 16;
+    bankChanged = true;
+  }
+}
@@ -0,0 +1,161 @@
+// Wren modulation effects, shaped per sample after the wavetable read
+// Header-only and free of Arduino dependencies, so the desktop tests
+// render exactly what the firmware plays
+
+#ifndef MODULATION_H
+#define MODULATION_H
+
+#include <math.h>
+#include <stdint.h>
+#include "sin_table.h"
+
+// Wavetable geometry
+const int WAVETABLE_SIZE = 32;  // 32 samples per waveform
+const int WAVETABLE_BITS = 5;   // log2(WAVETABLE_SIZE)
+
+// Modulation types
+enum ModulationType {
+  MOD_WAVEFOLDING = 0,  // Default
+  MOD_OVERFLOW = 1,
+  MOD_BITCRUSH = 2,
+  MOD_PHASE_DISTORTION = 3,
+  MOD_RESONANCE = 4,
+  NUM_MODULATION_TYPES = 5
+};
+
+// Per-mode constants, recomputed by updateModulationParams() only when
+// the modulation amount moves, so the per-sample functions below are
+// straight-line code with the same cost for every input
+struct ModulationParams {
+  float amount;        // Amount the constants were computed for
+  float dry;           // 1 - amount
+  float foldGain;      // Wavefolding input gain
+  float overflowGain;  // Overflow input gain
+  float crushStep;     // Bitcrush step size
+  float crushScale;    // 1 / crushStep
+  float pdDepth;       // Phase distortion depth in cycles
+};
+
+#define MODULATION_PARAMS_INIT { 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f }
+
+inline void updateModulationParams(ModulationParams& params, float amount) {
+  // Skip sub-LSB moves of the smoother's exponential tail
+  if (fabsf(amount - params.amount) < (1.0f / 4096.0f) && amount != 0.0f) return;
+
+  params.amount = amount;
+  params.dry = 1.0f - amount;
+  params.foldGain = 1.0f + amount * 4.0f;
+  params.overflowGain = 1.0f + amount * 3.0f;
+  params.crushStep = fmaxf(amount * 0.99f, 0.0001f);
+  params.crushScale = 1.0f / params.crushStep;
+  params.pdDepth = amount * 0.3f;
+}
+
+// Original wavefolding function
+inline float applyWavefolding(float input, const ModulationParams& params) {
+  // Scale input by fold amount (more folding = higher gain)
+  float scaled = input * params.foldGain;
+
+  // Triangle wave folding - reflects signal when it exceeds ±1.0. Closed
+  // form of the repeated reflection: a period-4 triangle through
+  // (-1, -1) and (1, 1)
+  float t = (scaled + 1.0f) * 0.25f;
+  t -= floorf(t);
+  float folded = 1.0f - fabsf(4.0f * t - 2.0f);
+
+  // Mix between original and folded signal
+  return input * params.dry + folded * params.amount;
+}
+
+// Overflow modulation - let signal wrap around instead of clipping
+inline float applyOverflow(float input, const ModulationParams& params) {
+  // Scale input to increase overflow probability
+  float scaled = input * params.overflowGain;
+
+  // Wrap around at ±1.0 boundaries
+  float wrapped = scaled - 2.0f * floorf((scaled + 1.0f) * 0.5f);
+
+  // Mix between original and overflowed signal
+  return input * params.dry + wrapped * params.amount;
+}
+
+// Bitcrush modulation - reduce bit depth for digital distortion
+inline float applyBitcrush(float input, const ModulationParams& params) {
+  // Quantize the input to step size (multiply by the precomputed reciprocal)
+  float crushed = floorf(input * params.crushScale + 0.5f) * params.crushStep;
+
+  // Clamp to valid range
+  return (crushed < -1.0f) ? -1.0f : (crushed > 1.0f) ? 1.0f : crushed;
+}
+
+// Phase Distortion modulation - distort wavetable read position
+inline float applyPhaseDistortion(float input, float currentPhase, const uint16_t* wavetable,
+                                  const ModulationParams& params) {
+  // Generate distorted phase using fast sine table
+  float distortedPhase = currentPhase + params.pdDepth * fastSin(currentPhase);
+
+  // Fast phase wrapping using fractional part
+  distortedPhase = distortedPhase - floorf(distortedPhase);
+
+  // Re-sample wavetable at distorted phase position
+  float distortedTablePos = distortedPhase * WAVETABLE_SIZE;
+  int index = (int)distortedTablePos;
+  float frac = distortedTablePos - index;
+
+  // Use bitwise AND for faster modulo (WAVETABLE_SIZE is 32)
+  uint16_t sample1 = wavetable[index & 31];
+  uint16_t sample2 = wavetable[(index + 1) & 31];
+
+  float distortedSample = sample1 + frac * (sample2 - sample1);
+  distortedSample = -((distortedSample - 32768.0f) * (1.0f / 32767.5f));
+
+  // Mix between original and phase-distorted signal
+  return input * params.dry + distortedSample * params.amount;
+}
+
+// Resonance modulation - CZ-101 style resonant synthesis
+inline float applyResonance(float input, float amount, float currentPhase) {
+  if (amount <= 0.0f) return input;
+
+  // Resonant frequency ratio (1.0x to 8.0x fundamental)
+  float resonantRatio = 1.0f + amount * 7.0f;
+
+  // Generate resonant frequency phase - use fractional part instead of fmod
+  float resonantPhase = (currentPhase * resonantRatio);
+  resonantPhase = resonantPhase - floorf(resonantPhase);
+
+  // Generate resonant sine wave using fast table
+  float resonantSine = fastSin(resonantPhase);
+
+  // Window function (fundamental frequency) for amplitude modulation
+  float windowAmp = fabsf(fastSin(currentPhase));
+
+  // Apply CZ-101 style resonant synthesis
+  float resonantSignal = resonantSine * windowAmp;
+
+  // Mix between original wavetable and resonant signal
+  return input * (1.0f - amount) + resonantSignal * amount;
+}
+
+// Master modulation dispatcher. Amount-dependent constants come from
+// `params`; `amount` is still passed for resonance. `currentPhase` is the
+// phase (0-1) of the voice being shaped, `wavetable` the table it reads.
+inline float applyModulation(float input, uint8_t modulationType, float amount, float currentPhase,
+                             const uint16_t* wavetable, const ModulationParams& params) {
+  switch (modulationType) {
+    case MOD_WAVEFOLDING:
+      return applyWavefolding(input, params);
+    case MOD_OVERFLOW:
+      return applyOverflow(input, params);
+    case MOD_BITCRUSH:
+      return applyBitcrush(input, params);
+    case MOD_PHASE_DISTORTION:
+      return applyPhaseDistortion(input, currentPhase, wavetable, params);
+    case MOD_RESONANCE:
+      return applyResonance(input, amount, currentPhase);
+    default:
+      return input;
+  }
+}
+
+#endif // MODULATION_H
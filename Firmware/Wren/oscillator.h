@@ -0,0 +1,136 @@
+// Wren oscillator: band-limited mipmaps and the per-voice wavetable read
+// Shared with the desktop golden tests and renderer like modulation.h,
+// so they play the same oscillator as renderFrame()
+
+#ifndef OSCILLATOR_H
+#define OSCILLATOR_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <FixedPoint.h>
+#include "modulation.h"
+#include "sin_table.h"
+
+// Band-limited mipmaps: level k keeps harmonics up to MAX_HARMONIC >> k
+// (16, 8, 4, 2, 1), built whenever a bank's wavetable changes. The playback
+// level is picked from frequency so no harmonic reaches Nyquist.
+const int MIPMAP_LEVELS = 5;
+const int MAX_HARMONIC = WAVETABLE_SIZE / 2;
+
+// Rebuild the band-limited copies of `source` into `levels`. Harmonic
+// analysis of the 32-sample cycle, then resynthesis with fewer harmonics
+// per level. sinTable has 8 entries per table step, so every sin/cos
+// needed is an exact table entry.
+inline void buildMipmapLevels(const uint16_t* source, uint16_t (*levels)[WAVETABLE_SIZE]) {
+  const int step = SIN_TABLE_SIZE / WAVETABLE_SIZE;
+  const int quarter = SIN_TABLE_SIZE / 4;   // cos(x) = sin(x + pi/2)
+  const float unit = 1.0f / 32767.0f;       // sinTable full scale
+
+  // Fourier coefficients; DC and Nyquist appear once in the inverse
+  // transform, every other harmonic twice
+  float cosine[MAX_HARMONIC + 1];
+  float sine[MAX_HARMONIC + 1];
+  for (int k = 0; k <= MAX_HARMONIC; k++) {
+    float c = 0.0f;
+    float s = 0.0f;
+    for (int n = 0; n < WAVETABLE_SIZE; n++) {
+      float x = (float)source[n] - 32768.0f;
+      int angle = k * n * step;
+      c += x * sinTable[(angle + quarter) & SIN_TABLE_MASK];
+      s += x * sinTable[angle & SIN_TABLE_MASK];
+    }
+    float weight = (k == 0 || k == MAX_HARMONIC) ? 1.0f : 2.0f;
+    cosine[k] = c * unit * weight / WAVETABLE_SIZE;
+    sine[k] = s * unit * weight / WAVETABLE_SIZE;
+  }
+
+  // Level 0 has every harmonic the table can hold: keep the original bits
+  memcpy(levels[0], source, WAVETABLE_SIZE * 2);
+
+  float levelSamples[WAVETABLE_SIZE];
+  for (int level = 1; level < MIPMAP_LEVELS; level++) {
+    int harmonics = MAX_HARMONIC >> level;
+    float peak = 32767.0f;
+    for (int n = 0; n < WAVETABLE_SIZE; n++) {
+      float y = cosine[0];
+      for (int k = 1; k <= harmonics; k++) {
+        int angle = k * n * step;
+        y += (cosine[k] * sinTable[(angle + quarter) & SIN_TABLE_MASK] +
+              sine[k] * sinTable[angle & SIN_TABLE_MASK]) * unit;
+      }
+      levelSamples[n] = y;
+      peak = fmaxf(peak, fabsf(y));
+    }
+
+    // Gibbs overshoot is scaled back into range rather than clipped, since
+    // clipping would put the removed harmonics back
+    float gain = 32767.0f / peak;
+    for (int n = 0; n < WAVETABLE_SIZE; n++) {
+      levels[level][n] = (uint16_t)(levelSamples[n] * gain + 32768.5f);
+    }
+  }
+}
+
+// Playback level for a voice at `topFrequency`: the first level whose top
+// harmonic stays below Nyquist
+inline uint8_t selectMipmapLevel(float topFrequency, float sampleRate) {
+  uint8_t level = 0;
+  while (level < MIPMAP_LEVELS - 1 && (MAX_HARMONIC >> level) * topFrequency >= sampleRate * 0.5f) {
+    level++;
+  }
+  return level;
+}
+
+// One voice at sub-step `step` of `steps` between this output sample and
+// the next: interpolated read of `table`, then applyModulation() when
+// `modulate`. The phase itself is left for advanceOscillatorPhase().
+inline float oscillatorSample(const uint16_t* table, float phase, float increment, int step, int steps,
+                              bool modulate, uint8_t mode, float amount, const ModulationParams& params) {
+  if (step > 0) {
+    phase += increment * ((float)step / (float)steps);
+    if (phase >= 1.0f) phase -= 1.0f;
+  }
+
+  // Linear interpolation between samples (16-bit unsigned values)
+  float tablePos = phase * WAVETABLE_SIZE;
+  int index = (int)tablePos;
+  float frac = tablePos - index;
+  uint16_t sample1 = table[index & (WAVETABLE_SIZE - 1)];
+  uint16_t sample2 = table[(index + 1) & (WAVETABLE_SIZE - 1)];
+
+  float sample = sample1 + frac * (sample2 - sample1);
+  sample = (sample - 32768.0f) * (1.0f / 32768.0f);  // Convert 0-65535 to -1.0 to 1.0
+
+  if (modulate) {
+    sample = applyModulation(sample, mode, amount, phase, table, params);
+  }
+  return sample;
+}
+
+// FIXED_POINT_DSP 1: table index and interpolation fraction straight from
+// the 32-bit phase bits
+inline q15_t oscillatorSampleQ15(const uint16_t* table, uint32_t phase, uint32_t increment, int step, int steps,
+                                 bool modulate, uint8_t mode, float amount, const ModulationParams& params) {
+  uint32_t phaseBits = phase + (uint32_t)step * (increment / (uint32_t)steps);
+  q15_t sample = wavetableLookupQ15(table, WAVETABLE_BITS, phaseBits);
+
+  if (modulate) {
+    float phaseFloat = (float)phaseBits * (1.0f / 4294967296.0f);
+    sample = floatToQ15(applyModulation(q15ToFloat(sample), mode, amount, phaseFloat, table, params));
+  }
+  return sample;
+}
+
+// Phase one output sample on
+inline float advanceOscillatorPhase(float phase, float increment) {
+  phase += increment;
+  if (phase >= 1.0f) phase -= 1.0f;
+  return phase;
+}
+
+inline uint32_t advanceOscillatorPhase(uint32_t phase, uint32_t increment) {
+  return phase + increment;
+}
+
+#endif // OSCILLATOR_H
@@ -2,52 +2,19 @@
 #define WAVEFORMS_H
 
 #include <Arduino.h>
+#include <Tables.h>
 
 // Default waveform presets for 32-sample wavetables
 // Each waveform uses 16-bit unsigned values (0-65535)
 // 32768 = center, 0 = minimum, 65535 = maximum
+// The geometric shapes are generated at compile time (Tables.h)
 
-const uint16_t PROGMEM preset_saw[32] = {
-  0, 2113, 4226, 6339, 8452, 10565, 12678, 14791,
-  16904, 19017, 21130, 23243, 25356, 27469, 29582, 31695,
-  33808, 35921, 38034, 40147, 42260, 44373, 46486, 48599,
-  50712, 52825, 54938, 57051, 59164, 61277, 63390, 65535
-};
-
-const uint16_t PROGMEM preset_sine[32] = {
-  32768, 39186, 45341, 51018, 56000, 60078, 63041, 64717,
-  65535, 64717, 63041, 60078, 56000, 51018, 45341, 39186,
-  32768, 26350, 20195, 14518, 9536, 5458, 2495, 819,
-  0, 819, 2495, 5458, 9536, 14518, 20195, 26350
-};
-
-const uint16_t PROGMEM preset_square[32] = {
-  65535, 65535, 65535, 65535, 65535, 65535, 65535, 65535,
-  65535, 65535, 65535, 65535, 65535, 65535, 65535, 65535,
-  0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0
-};
-
-const uint16_t PROGMEM preset_triangle[32] = {
-  32768, 36864, 40960, 45056, 49152, 53248, 57344, 61440,
-  65535, 61440, 57344, 53248, 49152, 45056, 40960, 36864,
-  32768, 28672, 24576, 20480, 16384, 12288, 8192, 4096,
-  0, 4096, 8192, 12288, 16384, 20480, 24576, 28672
-};
-
-const uint16_t PROGMEM preset_pulse50[32] = {
-  65535, 65535, 65535, 65535, 65535, 65535, 65535, 65535,
-  65535, 65535, 65535, 65535, 65535, 65535, 65535, 65535,
-  0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0
-};
-
-const uint16_t PROGMEM preset_pulse25[32] = {
-  65535, 65535, 65535, 65535, 65535, 65535, 65535, 65535,
-  0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0,
-  0, 0, 0, 0, 0, 0, 0, 0
-};
+constexpr LookupTable<uint16_t, 32> preset_saw = makeUint16Table<32>(TABLE_SAW);
+constexpr LookupTable<uint16_t, 32> preset_sine = makeUint16Table<32>(TABLE_SINE);
+constexpr LookupTable<uint16_t, 32> preset_square = makeUint16Table<32>(TABLE_PULSE);
+constexpr LookupTable<uint16_t, 32> preset_triangle = makeUint16Table<32>(TABLE_TRIANGLE);
+constexpr LookupTable<uint16_t, 32> preset_pulse50 = makeUint16Table<32>(TABLE_PULSE, 0.5);
+constexpr LookupTable<uint16_t, 32> preset_pulse25 = makeUint16Table<32>(TABLE_PULSE, 0.25);
 
 const uint16_t PROGMEM preset_harmonic_sine[32] = {
   32768, 42598, 51575, 58626, 62929, 63967, 61575, 55928,
@@ -65,14 +32,14 @@ const uint16_t PROGMEM preset_noise[32] = {
 
 // Array of pointers to all presets for easy access
 const uint16_t* const preset_waveforms[8] PROGMEM = {
-  preset_saw,           // Bank 0
-  preset_sine,          // Bank 1  
-  preset_square,        // Bank 2
-  preset_triangle,      // Bank 3
-  preset_pulse50,       // Bank 4
-  preset_pulse25,       // Bank 5
-  preset_harmonic_sine, // Bank 6
-  preset_noise          // Bank 7
+  preset_saw.values,      // Bank 0
+  preset_sine.values,     // Bank 1
+  preset_square.values,   // Bank 2
+  preset_triangle.values, // Bank 3
+  preset_pulse50.values,  // Bank 4
+  preset_pulse25.values,  // Bank 5
+  preset_harmonic_sine,   // Bank 6
+  preset_noise            // Bank 7
 };
 
 // Waveform names for debugging/display
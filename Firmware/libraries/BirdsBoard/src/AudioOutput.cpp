@@ -0,0 +1,153 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "AudioOutput.h"
+
+AudioOutput* AudioOutput::activeOutput = nullptr;
+
+AudioOutput::AudioOutput(I2S& i2s)
+  : i2s(i2s),
+    render(nullptr),
+    stereoRender(nullptr),
+    blockFrames(AUDIO_OUTPUT_MIN_FRAMES),
+    sampleRate(44100),
+    bufferReady(true),
+    buffersPlayed(0),
+    bufferPlayedMicros(0),
+    playOffset(1),
+    underruns(0),
+    blocksRendered(0),
+    lastRenderMicros(0),
+    maxRenderMicros(0) {
+}
+
+bool AudioOutput::begin(uint32_t rate, size_t frames, RenderCallback renderCallback) {
+  render = renderCallback;
+  stereoRender = nullptr;
+  return startI2S(rate, frames);
+}
+
+bool AudioOutput::begin(uint32_t rate, size_t frames, StereoRenderCallback renderCallback) {
+  render = nullptr;
+  stereoRender = renderCallback;
+  return startI2S(rate, frames);
+}
+
+bool AudioOutput::startI2S(uint32_t rate, size_t frames) {
+  blockFrames = constrain(frames, (size_t)AUDIO_OUTPUT_MIN_FRAMES, (size_t)AUDIO_OUTPUT_MAX_FRAMES);
+  sampleRate = rate;
+
+  // PT8211: 16-bit LSB-justified, one 32-bit word per stereo frame
+  i2s.setBitsPerSample(16);
+  i2s.setLSBJFormat();
+
+  // DMA buffers sized to one render block
+  if (!i2s.setBuffers(AUDIO_OUTPUT_DMA_BUFFERS, blockFrames)) {
+    return false;
+  }
+
+  activeOutput = this;
+  i2s.onTransmit(onBufferReady);
+
+  // The first block plays as the first buffer (of silence) finishes
+  buffersPlayed = 0;
+  bufferPlayedMicros = micros();
+  playOffset = 1;
+
+  return i2s.begin(sampleRate);
+}
+
+// DMA interrupt: a buffer has been played and is free again
+void AudioOutput::onBufferReady() {
+  if (activeOutput) {
+    activeOutput->bufferPlayedMicros = micros();
+    activeOutput->buffersPlayed = activeOutput->buffersPlayed + 1;
+    activeOutput->bufferReady = true;
+  }
+}
+
+uint32_t AudioOutput::getBlockMicros() const {
+  // The interrupt may land between the two reads; take a consistent pair
+  uint32_t played;
+  uint32_t playedMicros;
+  do {
+    played = buffersPlayed;
+    playedMicros = bufferPlayedMicros;
+  } while (played != buffersPlayed);
+
+  // Buffers from the last finished one to this block's start, less the
+  // latency
+  int32_t buffers = (int32_t)(blocksRendered + playOffset - played) - AUDIO_OUTPUT_DMA_BUFFERS;
+  int64_t frames = (int64_t)buffers * (int64_t)blockFrames;
+  return playedMicros + (uint32_t)(int32_t)(frames * 1000000 / (int64_t)sampleRate);
+}
+
+void AudioOutput::update() {
+  if (!bufferReady || (!render && !stereoRender)) {
+    return;
+  }
+  bufferReady = false;
+
+  const int blockBytes = blockFrames * sizeof(uint32_t);
+
+  while (i2s.availableForWrite() >= blockBytes) {
+    syncDrainedRing();
+
+    uint32_t start = micros();
+    if (stereoRender) {
+      stereoRender(monoBlock, rightBlock, blockFrames);
+
+      // Left in the high half-word, as I2S::write16(left, right)
+      for (size_t i = 0; i < blockFrames; i++) {
+        stereoBlock[i] = ((uint32_t)(uint16_t)monoBlock[i] << 16) | (uint16_t)rightBlock[i];
+      }
+    } else {
+      render(monoBlock, blockFrames);
+
+      // Same sample on both channels
+      for (size_t i = 0; i < blockFrames; i++) {
+        uint16_t sample = (uint16_t)monoBlock[i];
+        stereoBlock[i] = ((uint32_t)sample << 16) | sample;
+      }
+    }
+
+    lastRenderMicros = micros() - start;
+    if (lastRenderMicros > maxRenderMicros) {
+      maxRenderMicros = lastRenderMicros;
+    }
+
+    // Again as it is queued: a silence buffer may have finished meanwhile
+    syncDrainedRing();
+    i2s.write((const uint8_t*)stereoBlock, blockBytes);
+    blocksRendered++;
+  }
+
+  // The DMA played silence because no block was ready in time
+  if (i2s.getUnderflow()) {
+    underruns++;
+  }
+}
+
+// Every buffer free: the DMA ran out and plays silence, so the block
+// queued next starts as the current buffer finishes
+void AudioOutput::syncDrainedRing() {
+  if (i2s.availableForWrite() >= AUDIO_OUTPUT_DMA_BUFFERS * (int)(blockFrames * sizeof(uint32_t))) {
+    playOffset = buffersPlayed + 1 - blocksRendered;
+  }
+}
+
+void AudioOutput::resetStats() {
+  // blocksRendered also places blocks on the sample clock
+  playOffset += blocksRendered;
+  underruns = 0;
+  blocksRendered = 0;
+  lastRenderMicros = 0;
+  maxRenderMicros = 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_AUDIO_OUTPUT_H
+#define BIRDSBOARD_AUDIO_OUTPUT_H
+
+#include <Arduino.h>
+#include <I2S.h>
+
+// Block size limits (frames per DMA buffer)
+#define AUDIO_OUTPUT_MIN_FRAMES 32
+#define AUDIO_OUTPUT_MAX_FRAMES 256
+
+// DMA buffers in the I2S ring: two ping-pong while the next block renders
+#define AUDIO_OUTPUT_DMA_BUFFERS 3
+
+/**
+ * Block-based, DMA double-buffered I2S output for the PT8211
+ *
+ * The I2S DMA plays from a ring of buffers. When one finishes, the
+ * buffer-ready interrupt flags it and update() calls the render callback
+ * for one block of samples, mono (copied to both channels) or stereo,
+ * then queues it.
+ * Outside of that render call the CPU is free, so serial handling or
+ * control work in loop() no longer paces the audio.
+ *
+ * Blocks are also placed on the sample clock. The interrupt counts the
+ * buffers the DMA has finished and timestamps the last one. Block n starts
+ * playing when a known buffer finishes, so its play-out time follows from
+ * that timestamp and n * blockFrames. It does not depend on when the block
+ * happened to render. getBlockMicros() gives that time less a fixed
+ * latency, for placing timestamped input (gate edges) in the block.
+ */
+class AudioOutput {
+public:
+  // Fills `out` with `frames` mono 16-bit samples
+  typedef void (*RenderCallback)(int16_t* out, size_t frames);
+
+  // Fills `left` and `right` with `frames` 16-bit samples each
+  typedef void (*StereoRenderCallback)(int16_t* left, int16_t* right, size_t frames);
+
+  explicit AudioOutput(I2S& i2s);
+
+  // Configure the I2S DMA buffers and start output. `blockFrames` is
+  // clamped to AUDIO_OUTPUT_MIN_FRAMES..AUDIO_OUTPUT_MAX_FRAMES.
+  bool begin(uint32_t sampleRate, size_t blockFrames, RenderCallback render);
+  bool begin(uint32_t sampleRate, size_t blockFrames, StereoRenderCallback render);
+
+  // Call often from loop(): renders a block for every free DMA buffer and
+  // returns immediately when none is free
+  void update();
+
+  size_t getBlockFrames() const { return blockFrames; }
+
+  // In the render callback: the time the block's first frame stands for,
+  // AUDIO_OUTPUT_DMA_BUFFERS blocks before it plays. It advances exactly
+  // one block per render, including when blocks render back to back at
+  // start-up or after a stall, so an input timestamped in micros() lands
+  // at that latency (and is not late for its block while renders keep up).
+  uint32_t getBlockMicros() const;
+
+  // Counters
+  uint32_t getUnderruns() const { return underruns; }
+  uint32_t getBlocksRendered() const { return blocksRendered; }
+  uint32_t getLastRenderMicros() const { return lastRenderMicros; }
+  uint32_t getMaxRenderMicros() const { return maxRenderMicros; }
+  void resetStats();
+
+private:
+  static void onBufferReady();
+  static AudioOutput* activeOutput;
+
+  bool startI2S(uint32_t rate, size_t frames);
+  void syncDrainedRing();
+
+  I2S& i2s;
+  RenderCallback render;
+  StereoRenderCallback stereoRender;
+  size_t blockFrames;
+  uint32_t sampleRate;
+  volatile bool bufferReady;
+
+  // Sample clock: DMA buffers finished (silence included) and when the last
+  // one did. Block n starts playing as buffer n + playOffset finishes.
+  volatile uint32_t buffersPlayed;
+  volatile uint32_t bufferPlayedMicros;
+  uint32_t playOffset;
+
+  int16_t monoBlock[AUDIO_OUTPUT_MAX_FRAMES];  // Mono, or left in stereo
+  int16_t rightBlock[AUDIO_OUTPUT_MAX_FRAMES];
+  uint32_t stereoBlock[AUDIO_OUTPUT_MAX_FRAMES];
+
+  uint32_t underruns;
+  uint32_t blocksRendered;
+  uint32_t lastRenderMicros;
+  uint32_t maxRenderMicros;
+};
+
+#endif // BIRDSBOARD_AUDIO_OUTPUT_H
@@ -0,0 +1,33 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_H
+#define BIRDSBOARD_H
+
+/**
+ * Everything the sketches share, in one include
+ *
+ * Only AudioOutput and the flash device behind FlashLog depend on the
+ * Arduino core and the Pico SDK. The DSP, tables, controls, CRC, gate
+ * capture and telemetry headers are header-only and free of Arduino
+ * dependencies, so the desktop simulator and its tests build the same
+ * code on the host.
+ */
+
+#include "AudioOutput.h"
+#include "Controls.h"
+#include "Crc.h"
+#include "FlashLog.h"
+#include "FixedPoint.h"
+#include "GateCapture.h"
+#include "Tables.h"
+#include "Telemetry.h"
+
+#endif // BIRDSBOARD_H
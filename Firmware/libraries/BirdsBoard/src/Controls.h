@@ -0,0 +1,148 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_CONTROLS_H
+#define BIRDSBOARD_CONTROLS_H
+
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * Control inputs shared by every BirdsBoard firmware and the simulator:
+ * the ADC calibration of the four CV/knob inputs, their conversion to
+ * volts and 1V/oct pitch, and the averaging ADC filter.
+ *
+ * The CV inputs reach the 12-bit ADC as 0.33 x CV + 1.65V; the pitch CV
+ * input is inverted.
+ */
+
+// ADC range calibration (from CLAUDE.md)
+#define PITCH_CV_MIN    0
+#define PITCH_CV_MAX    4095
+#define PITCH_KNOB_MIN  10
+#define PITCH_KNOB_MAX  4000
+#define CV1_MIN         8
+#define CV1_MAX         2000
+#define CV2_MIN         8
+#define CV2_MAX         2000
+
+// Input op-amp scaling: ADC volts = CV volts * CV_INPUT_GAIN + CV_INPUT_OFFSET
+#define ADC_VREF        3.3f
+#define ADC_MAX_VALUE   4095
+#define CV_INPUT_GAIN   0.33f
+#define CV_INPUT_OFFSET 1.65f
+
+// Pitch CV in volts (0-5V, one octave per volt)
+inline float pitchCvVolts(uint16_t raw) {
+  float adcVoltage = ((float)(PITCH_CV_MAX - raw) / (float)PITCH_CV_MAX) * ADC_VREF;
+  float volts = (adcVoltage - CV_INPUT_OFFSET) / CV_INPUT_GAIN;
+  if (volts < 0.0f) return 0.0f;
+  if (volts > 5.0f) return 5.0f;
+  return volts;
+}
+
+// Pitch knob in octaves, -1 to +1 around the centre detent
+inline float pitchKnobOctaves(uint16_t raw) {
+  float knobVoltage = ((float)((int)raw - PITCH_KNOB_MIN) / (float)(PITCH_KNOB_MAX - PITCH_KNOB_MIN)) * ADC_VREF;
+  if (knobVoltage < 0.0f) knobVoltage = 0.0f;
+  if (knobVoltage > ADC_VREF) knobVoltage = ADC_VREF;
+  return (knobVoltage - CV_INPUT_OFFSET) / CV_INPUT_OFFSET;
+}
+
+// 2^x over one octave, PITCH_TABLE_SIZE linear segments (error below
+// 0.002 cents). Generated at compile time into flash.
+#define PITCH_TABLE_BITS 8
+#define PITCH_TABLE_SIZE (1 << PITCH_TABLE_BITS)
+
+struct Exp2Table {
+  float values[PITCH_TABLE_SIZE + 1];  // 2^(i / PITCH_TABLE_SIZE), plus the guard entry 2.0
+
+  constexpr Exp2Table() : values() {
+    for (int i = 0; i <= PITCH_TABLE_SIZE; i++) {
+      // e^(x ln 2) by its Taylor series - evaluated by the compiler only
+      double x = 0.6931471805599453 * i / PITCH_TABLE_SIZE;
+      double term = 1.0;
+      double sum = 1.0;
+      for (int n = 1; n < 20; n++) {
+        term *= x / n;
+        sum += term;
+      }
+      values[i] = (float)sum;
+    }
+  }
+};
+
+inline constexpr Exp2Table exp2Table;
+
+// 2^x: the fraction from the table, the integer part into the exponent
+inline float exp2Lookup(float x) {
+  float octave = floorf(x);
+  float position = (x - octave) * PITCH_TABLE_SIZE;
+  int index = (int)position;
+  if (index >= PITCH_TABLE_SIZE) index = PITCH_TABLE_SIZE - 1;
+  float frac = position - (float)index;
+
+  float low = exp2Table.values[index];
+  float mantissa = low + frac * (exp2Table.values[index + 1] - low);
+  return ldexpf(mantissa, (int)octave);
+}
+
+// 1V/oct: frequency `octaves` above (or below) A440
+inline float octavesToFrequency(float octaves) {
+  return 440.0f * exp2Lookup(octaves);
+}
+
+// Running average of ADC_AVERAGE_SAMPLES readings, then a deadband on the
+// averaged value: stable enough for bank and algorithm selection
+#define ADC_AVERAGE_SAMPLES 16
+
+struct AveragingADCFilter {
+  uint16_t filtered;     // Current filtered value (integer for stability)
+  uint16_t lastOutput;   // Last output value
+  uint32_t accumulator;  // Running sum for averaging
+  uint8_t sampleCount;   // Number of samples in accumulator
+  uint16_t deadband;     // Deadband threshold
+
+  void begin(uint16_t deadbandCounts) {
+    filtered = 0;
+    lastOutput = 0;
+    accumulator = 0;
+    sampleCount = 0;
+    deadband = deadbandCounts;
+  }
+
+  void process(uint16_t raw) {
+    accumulator += raw;
+    sampleCount++;
+
+    // Calculate average when we have enough samples
+    if (sampleCount < ADC_AVERAGE_SAMPLES) {
+      return;
+    }
+    uint16_t average = accumulator / ADC_AVERAGE_SAMPLES;
+    accumulator = 0;
+    sampleCount = 0;
+
+    if (filtered == 0) {
+      // Initialize
+      filtered = average;
+      lastOutput = average;
+    } else {
+      // Apply deadband - only update if change is significant
+      int change = (int)average - (int)lastOutput;
+      if (change > deadband || -change > deadband) {
+        filtered = average;
+        lastOutput = average;
+      }
+    }
+  }
+};
+
+#endif // BIRDSBOARD_CONTROLS_H
@@ -0,0 +1,43 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_CRC_H
+#define BIRDSBOARD_CRC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection, no final
+ * XOR) for framed serial transfers and stored records
+ *
+ * Bitwise rather than table-driven: the frames are a few hundred bytes
+ * and are checked off the audio path, so 512 bytes of table aren't worth
+ * it. Pass the previous result as `crc` to continue over several pieces.
+ */
+
+#define CRC16_INIT 0xFFFF
+
+inline uint16_t crc16Update(uint16_t crc, uint8_t data) {
+  crc ^= (uint16_t)data << 8;
+  for (int bit = 0; bit < 8; bit++) {
+    crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+inline uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc = CRC16_INIT) {
+  for (size_t i = 0; i < length; i++) {
+    crc = crc16Update(crc, data[i]);
+  }
+  return crc;
+}
+
+#endif // BIRDSBOARD_CRC_H
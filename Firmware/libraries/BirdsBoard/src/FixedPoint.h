@@ -0,0 +1,195 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_FIXED_POINT_H
+#define BIRDSBOARD_FIXED_POINT_H
+
+#include <stdint.h>
+
+/**
+ * Fixed-point DSP building blocks: Q15 samples, Q31 envelopes, Q3.28
+ * biquad coefficients with Q4.27 state
+ *
+ * Used by the sketches when FIXED_POINT_DSP is set to 1. Float is only
+ * touched when a coefficient is set, so the per-sample recursion is
+ * integer multiply-accumulate (SMULL/SMLAL on the Cortex-M33) and gives
+ * the same bits on every target, so the simulator tests can check it
+ * against the float path.
+ */
+
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+#define Q15_MAX 32767
+#define Q15_MIN (-32768)
+#define Q31_MAX 0x7FFFFFFF
+
+// Biquad formats: coefficients up to +/-8, signal headroom up to +/-16
+// for resonant peaks
+#define BIQUAD_COEFF_BITS 28
+#define BIQUAD_STATE_BITS 27
+
+inline q15_t saturateQ15(int32_t x) {
+  if (x > Q15_MAX) return Q15_MAX;
+  if (x < Q15_MIN) return Q15_MIN;
+  return (q15_t)x;
+}
+
+// Float <-> fixed with `fracBits` fractional bits, rounded to nearest
+inline int32_t floatToFixed(float x, int fracBits) {
+  float scaled = x * (float)(1UL << fracBits);
+  if (scaled >= 2147483520.0f) return Q31_MAX;
+  if (scaled <= -2147483648.0f) return (int32_t)0x80000000;
+  return (int32_t)(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+}
+
+inline float fixedToFloat(int32_t x, int fracBits) {
+  return (float)x * (1.0f / (float)(1UL << fracBits));
+}
+
+inline q15_t floatToQ15(float x) {
+  return saturateQ15(floatToFixed(x, 15));
+}
+
+inline float q15ToFloat(q15_t x) {
+  return (float)x * (1.0f / 32768.0f);
+}
+
+inline q31_t floatToQ31(float x) {
+  if (x >= 1.0f) return Q31_MAX;
+  if (x <= -1.0f) return (q31_t)0x80000000;
+  return (q31_t)(x * 2147483648.0f);
+}
+
+inline float q31ToFloat(q31_t x) {
+  return (float)x * (1.0f / 2147483648.0f);
+}
+
+// Rounded Q31 x Q31 -> Q31
+inline q31_t mulQ31(q31_t a, q31_t b) {
+  return (q31_t)(((int64_t)a * b + (1LL << 30)) >> 31);
+}
+
+// Per-sample increment of a 32-bit phase (one cycle per 2^32), clamped
+// to 0..sampleRate / 2
+inline uint32_t phaseIncrement(float frequency, float sampleRate) {
+  float cycles = frequency / sampleRate;
+  if (cycles < 0.0f) cycles = 0.0f;
+  if (cycles > 0.5f) cycles = 0.5f;
+  return (uint32_t)(cycles * 4294967296.0f);
+}
+
+// 32-bit phase accumulator: one cycle per 2^32, wraps for free
+struct PhaseAccumulator {
+  uint32_t phase;
+  uint32_t increment;
+
+  void reset() { phase = 0; }
+
+  // `frequency` must stay below sampleRate / 2
+  void setFrequency(float frequency, float sampleRate) {
+    increment = phaseIncrement(frequency, sampleRate);
+  }
+
+  // Returns the current phase and advances one sample
+  uint32_t next() {
+    uint32_t out = phase;
+    phase += increment;
+    return out;
+  }
+
+  float toFloat() const { return (float)phase * (1.0f / 4294967296.0f); }
+};
+
+// Linear interpolation in a table of (1 << indexBits) unsigned 16-bit
+// samples centred on 32768 (the DAC format the Wren wavetables use).
+// The top bits of `phase` pick the entry, all remaining bits are the
+// interpolation fraction.
+inline q15_t wavetableLookupQ15(const uint16_t* table, int indexBits, uint32_t phase) {
+  const int fracBits = 32 - indexBits;
+  uint32_t mask = (1UL << indexBits) - 1;
+  uint32_t index = phase >> fracBits;
+  int64_t frac = phase & ((1UL << fracBits) - 1);
+
+  int32_t s1 = table[index];
+  int32_t s2 = table[(index + 1) & mask];
+
+  // One SMULL: a full-scale step times the fraction, rounded
+  int32_t delta = (int32_t)(((s2 - s1) * frac + (1LL << (fracBits - 1))) >> fracBits);
+  return (q15_t)(s1 + delta - 32768);
+}
+
+// Exponential decay: one Q31 multiply per sample
+struct DecayEnvelopeQ31 {
+  q31_t value;
+  q31_t coeff;
+
+  // `coeff` is the per-sample multiplier, e.g. expf(-rate / sampleRate)
+  void trigger(float coefficient) {
+    value = Q31_MAX;
+    coeff = floatToQ31(coefficient);
+  }
+
+  void restart() { value = Q31_MAX; }
+
+  // Returns the current value and advances one sample
+  q31_t process() {
+    q31_t out = value;
+    value = mulQ31(value, coeff);
+    return out;
+  }
+};
+
+// Direct form I biquad: y = a0*x + a1*x1 + a2*x2 - b1*y1 - b2*y2
+// (the Tockus coefficient naming). Signals are Q4.27.
+struct BiquadQ31 {
+  int32_t a0, a1, a2, b1, b2;
+  int32_t x1, x2, y1, y2;
+  int64_t residual;  // Truncated bits carried into the next sample
+
+  void reset() {
+    x1 = x2 = y1 = y2 = 0;
+    residual = 0;
+  }
+
+  void setCoefficients(float fa0, float fa1, float fa2, float fb1, float fb2) {
+    a0 = floatToFixed(fa0, BIQUAD_COEFF_BITS);
+    a1 = floatToFixed(fa1, BIQUAD_COEFF_BITS);
+    a2 = floatToFixed(fa2, BIQUAD_COEFF_BITS);
+    b1 = floatToFixed(fb1, BIQUAD_COEFF_BITS);
+    b2 = floatToFixed(fb2, BIQUAD_COEFF_BITS);
+  }
+
+  int32_t process(int32_t input) {
+    int64_t acc = (int64_t)a0 * input + (int64_t)a1 * x1 + (int64_t)a2 * x2
+                  - (int64_t)b1 * y1 - (int64_t)b2 * y2 + residual;
+    int32_t output = (int32_t)(acc >> BIQUAD_COEFF_BITS);
+
+    // First-order error feedback: poles near z = 1 (low cutoff, high Q)
+    // would otherwise amplify the rounding noise far above one LSB.
+    // Multiply, not shift: `output` is often negative.
+    residual = acc - (int64_t)output * (1LL << BIQUAD_COEFF_BITS);
+
+    x2 = x1;
+    x1 = input;
+    y2 = y1;
+    y1 = output;
+
+    return output;
+  }
+
+  // Float in/out around the integer recursion (VCVT with fraction bits
+  // on the M33)
+  float processFloat(float input) {
+    return fixedToFloat(process(floatToFixed(input, BIQUAD_STATE_BITS)), BIQUAD_STATE_BITS);
+  }
+};
+
+#endif // BIRDSBOARD_FIXED_POINT_H
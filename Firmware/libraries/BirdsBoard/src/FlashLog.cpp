@@ -0,0 +1,306 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "FlashLog.h"
+#include "Crc.h"
+#include <stddef.h>
+#include <string.h>
+
+#define FLASH_LOG_MAGIC 0x4C42  // "BL"
+
+static_assert(FLASH_LOG_MAX_KEYS < FLASH_LOG_PAGES_PER_SECTOR, "live records must fit in one sector");
+
+FlashLog::FlashLog(const FlashLogDevice& device)
+  : device(device),
+    baseOffset(0),
+    sectorCount(0),
+    pageCount(0),
+    head(0),
+    nextSequence(1),
+    pendingErase(-1),
+    backgroundErase(false),
+    ready(false),
+    pagesWritten(0),
+    sectorsErased(0) {
+}
+
+bool FlashLog::begin(uint32_t flashOffset, uint32_t sectors) {
+  ready = false;
+  if (sectors < 2 || (flashOffset % FLASH_LOG_SECTOR_SIZE) != 0) {
+    return false;
+  }
+
+  baseOffset = flashOffset;
+  sectorCount = sectors;
+  pageCount = sectors * FLASH_LOG_PAGES_PER_SECTOR;
+  pendingErase = -1;
+  backgroundErase = device.canSuspend();
+
+  // One pass over the region: newest valid record per key, newest overall
+  int32_t newestPage = -1;
+  uint32_t newestSequence = 0;
+  for (int key = 0; key < FLASH_LOG_MAX_KEYS; key++) {
+    latest[key] = -1;
+  }
+
+  for (uint32_t page = 0; page < pageCount; page++) {
+    if (!isValid(page)) {
+      continue;
+    }
+    const Header* header = pageHeader(page);
+    if (latest[header->key] < 0 || header->sequence > pageHeader(latest[header->key])->sequence) {
+      latest[header->key] = page;
+    }
+    if (newestPage < 0 || header->sequence > newestSequence) {
+      newestPage = page;
+      newestSequence = header->sequence;
+    }
+  }
+
+  // Nothing stored: start clean
+  if (newestPage < 0) {
+    format();
+    return true;
+  }
+
+  nextSequence = newestSequence + 1;
+  head = newestPage;
+
+  // Continue after the newest record, past any torn page
+  uint32_t skipped = 0;
+  do {
+    advanceHead();
+    if (++skipped > pageCount) {
+      return false;  // Nowhere left to write
+    }
+  } while (!isErased(head));
+
+  // An interrupted recycle or erase leaves the spare sector unerased:
+  // copy what is still live out of it, service() erases the rest
+  uint32_t spare = (head / FLASH_LOG_PAGES_PER_SECTOR + 1) % sectorCount;
+  if (!isSectorErased(spare) && !recycleSector(spare)) {
+    return false;
+  }
+
+  // Nothing can erase it once running
+  if (!backgroundErase) {
+    finishErase();
+  }
+
+  ready = true;
+  return true;
+}
+
+void FlashLog::format() {
+  finishErase();
+  for (uint32_t sector = 0; sector < sectorCount; sector++) {
+    if (!isSectorErased(sector)) {
+      eraseSector(sector, 0);
+    }
+  }
+  for (int key = 0; key < FLASH_LOG_MAX_KEYS; key++) {
+    latest[key] = -1;
+  }
+  head = 0;
+  nextSequence = 1;
+  ready = sectorCount >= 2;
+}
+
+bool FlashLog::service() {
+  if (pendingErase < 0 || !backgroundErase) {
+    return false;
+  }
+  if (eraseSector(pendingErase, FLASH_LOG_ERASE_SLICE_US)) {
+    pendingErase = -1;
+    return false;
+  }
+  return true;
+}
+
+// The pending erase to its end, in one go
+void FlashLog::finishErase() {
+  if (pendingErase >= 0) {
+    eraseSector(pendingErase, 0);
+    pendingErase = -1;
+  }
+}
+
+bool FlashLog::isEmpty() const {
+  for (int key = 0; key < FLASH_LOG_MAX_KEYS; key++) {
+    if (latest[key] >= 0) return false;
+  }
+  return true;
+}
+
+const uint8_t* FlashLog::find(uint8_t key, uint16_t* length) const {
+  if (!ready || key >= FLASH_LOG_MAX_KEYS || latest[key] < 0) {
+    return nullptr;
+  }
+
+  const Header* header = pageHeader(latest[key]);
+  if (length) {
+    *length = header->length;
+  }
+  return (const uint8_t*)header + FLASH_LOG_HEADER_SIZE;
+}
+
+bool FlashLog::write(uint8_t key, const void* data, uint16_t length) {
+  if (!ready || key >= FLASH_LOG_MAX_KEYS || length > FLASH_LOG_MAX_PAYLOAD) {
+    return false;
+  }
+
+  // Diff against what is stored: unchanged data costs no flash write
+  uint16_t storedLength;
+  const uint8_t* stored = find(key, &storedLength);
+  if (stored && storedLength == length && memcmp(stored, data, length) == 0) {
+    return true;
+  }
+
+  return append(key, (const uint8_t*)data, length);
+}
+
+const FlashLog::Header* FlashLog::pageHeader(uint32_t page) const {
+  return (const Header*)device.read(baseOffset + page * FLASH_LOG_PAGE_SIZE);
+}
+
+bool FlashLog::isValid(uint32_t page) const {
+  const Header* header = pageHeader(page);
+  if (header->magic != FLASH_LOG_MAGIC || header->key >= FLASH_LOG_MAX_KEYS ||
+      header->length > FLASH_LOG_MAX_PAYLOAD) {
+    return false;
+  }
+
+  const uint8_t* bytes = (const uint8_t*)header;
+  uint16_t crc = crc16(bytes, offsetof(Header, crc));
+  crc = crc16(bytes + FLASH_LOG_HEADER_SIZE, header->length, crc);
+  return crc == header->crc;
+}
+
+bool FlashLog::isErased(uint32_t page) const {
+  const uint32_t* words = (const uint32_t*)pageHeader(page);
+  for (int i = 0; i < FLASH_LOG_PAGE_SIZE / 4; i++) {
+    if (words[i] != 0xFFFFFFFF) return false;
+  }
+  return true;
+}
+
+bool FlashLog::isSectorErased(uint32_t sector) const {
+  for (uint32_t i = 0; i < FLASH_LOG_PAGES_PER_SECTOR; i++) {
+    if (!isErased(sector * FLASH_LOG_PAGES_PER_SECTOR + i)) return false;
+  }
+  return true;
+}
+
+bool FlashLog::append(uint8_t key, const uint8_t* data, uint16_t length) {
+  static_assert(sizeof(Header) == FLASH_LOG_HEADER_SIZE, "header layout");
+
+  // Never program over data (only after a region was damaged outside
+  // this class)
+  if (!isErased(head)) {
+    return false;
+  }
+
+  // Build the page in RAM: `data` may point into flash, which can't be
+  // read while the page is programmed
+  memset(pageBuffer, 0xFF, sizeof(pageBuffer));
+  Header header = {};
+  header.magic = FLASH_LOG_MAGIC;
+  header.key = key;
+  header.reserved = 0xFF;
+  header.sequence = nextSequence;
+  header.length = length;
+  memcpy(pageBuffer + FLASH_LOG_HEADER_SIZE, data, length);
+  header.crc = crc16((const uint8_t*)&header, offsetof(Header, crc));
+  header.crc = crc16(pageBuffer + FLASH_LOG_HEADER_SIZE, length, header.crc);
+  memcpy(pageBuffer, &header, sizeof(header));
+
+  uint32_t page = head;
+  programPage(page, pageBuffer);
+  nextSequence++;
+
+  // Read back; a bad page is simply skipped by the next scan. The index
+  // is updated before the head moves on, so a recycle triggered by the
+  // move copies this record and not the one it replaces.
+  bool written = isValid(page);
+  if (written) {
+    latest[key] = page;
+  }
+
+  advanceHead();
+  return written;
+}
+
+void FlashLog::advanceHead() {
+  head = (head + 1) % pageCount;
+
+  // Entered the spare sector: the one after it becomes the new spare.
+  // The spare's erase only blocks here if service() fell behind (or the
+  // power was cut before it finished).
+  if (head % FLASH_LOG_PAGES_PER_SECTOR == 0) {
+    uint32_t sector = head / FLASH_LOG_PAGES_PER_SECTOR;
+    if (pendingErase == (int32_t)sector || !isSectorErased(sector)) {
+      // Without erase suspend, only begin() erases (the log is full until
+      // the next boot)
+      if (ready && !backgroundErase) {
+        return;
+      }
+      finishErase();
+      if (!isSectorErased(sector)) {
+        eraseSector(sector, 0);
+      }
+    }
+    recycleSector((sector + 1) % sectorCount);
+  }
+}
+
+// Copy the live records of `sector` to the head, then leave it to
+// service() to erase
+bool FlashLog::recycleSector(uint32_t sector) {
+  uint32_t first = sector * FLASH_LOG_PAGES_PER_SECTOR;
+  uint32_t last = first + FLASH_LOG_PAGES_PER_SECTOR;
+
+  for (int key = 0; key < FLASH_LOG_MAX_KEYS; key++) {
+    if (latest[key] < (int32_t)first || latest[key] >= (int32_t)last) {
+      continue;
+    }
+
+    // The copies must land outside the sector being recycled
+    uint32_t target = head / FLASH_LOG_PAGES_PER_SECTOR;
+    if (target == sector || (head % FLASH_LOG_PAGES_PER_SECTOR) == FLASH_LOG_PAGES_PER_SECTOR - 1) {
+      return false;
+    }
+
+    const Header* header = pageHeader(latest[key]);
+    if (!append(key, (const uint8_t*)header + FLASH_LOG_HEADER_SIZE, header->length)) {
+      return false;
+    }
+  }
+
+  if (!isSectorErased(sector)) {
+    if (pendingErase != (int32_t)sector) {
+      finishErase();
+    }
+    pendingErase = sector;
+  }
+  return true;
+}
+
+void FlashLog::programPage(uint32_t page, const uint8_t* data) {
+  device.program(baseOffset + page * FLASH_LOG_PAGE_SIZE, data);
+  pagesWritten++;
+}
+
+bool FlashLog::eraseSector(uint32_t sector, uint32_t sliceMicros) {
+  if (!device.erase(baseOffset + sector * FLASH_LOG_SECTOR_SIZE, sliceMicros)) {
+    return false;
+  }
+  sectorsErased++;
+  return true;
+}
@@ -0,0 +1,162 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_FLASH_LOG_H
+#define BIRDSBOARD_FLASH_LOG_H
+
+#include <stdint.h>
+
+// Flash geometry (RP2040/RP2350 QSPI flash)
+#define FLASH_LOG_PAGE_SIZE 256
+#define FLASH_LOG_SECTOR_SIZE 4096
+#define FLASH_LOG_PAGES_PER_SECTOR (FLASH_LOG_SECTOR_SIZE / FLASH_LOG_PAGE_SIZE)
+
+// One record per page: 12-byte header, the rest payload
+#define FLASH_LOG_HEADER_SIZE 12
+#define FLASH_LOG_MAX_PAYLOAD (FLASH_LOG_PAGE_SIZE - FLASH_LOG_HEADER_SIZE)
+
+// Keys 0..FLASH_LOG_MAX_KEYS-1. Fewer live keys than pages per sector, so
+// a sector's live records always fit in the fresh sector before it.
+#define FLASH_LOG_MAX_KEYS 15
+
+// Longest the other core is parked per erase slice in service()
+#define FLASH_LOG_ERASE_SLICE_US 1000
+
+/**
+ * Flash primitives FlashLog runs on: the RP2040/RP2350 QSPI flash
+ * (qspiFlashDevice) on the hardware, a RAM array in the host tests.
+ * Offsets are bytes from the start of flash.
+ */
+struct FlashLogDevice {
+  // Memory-mapped contents at `offset`
+  const uint8_t* (*read)(uint32_t offset);
+
+  // Program one FLASH_LOG_PAGE_SIZE page (bits only go from 1 to 0)
+  void (*program)(uint32_t offset, const uint8_t* page);
+
+  // Erase the sector at `offset` for at most about `sliceMicros` (0 = to
+  // the end), then suspend. Returns true once the sector is erased; the
+  // next call, always with the same offset, resumes it. Pages of other
+  // sectors can be read and programmed while it is suspended.
+  bool (*erase)(uint32_t offset, uint32_t sliceMicros);
+
+  // Whether erase() can stop part-way (erase suspend). Without it every
+  // erase runs to the end however short the slice.
+  bool (*canSuspend)();
+};
+
+#if defined(ARDUINO_ARCH_RP2040)
+// The chip's own flash (FlashLogQspi.cpp), RP2040 and RP2350
+extern const FlashLogDevice qspiFlashDevice;
+#endif
+
+/**
+ * Append-only, wear-leveled key/value record log in raw flash
+ *
+ * Every save appends one page-sized record (key, sequence number, CRC-16)
+ * at the head; the newest valid record of a key wins. When the head
+ * enters a new sector, the live records of the oldest sector are copied
+ * forward and that sector becomes the next spare, so erases rotate over
+ * all sectors. A torn write fails its CRC and the previous record of that
+ * key is used instead.
+ *
+ * The save path never erases. The retired sector is marked pending and
+ * service(), called from an idle loop, erases it one slice of at most
+ * FLASH_LOG_ERASE_SLICE_US at a time, so the other core is never parked
+ * for longer than its queued I2S buffers cover. It has
+ * FLASH_LOG_PAGES_PER_SECTOR appends to finish; an append that catches up
+ * with it finishes the erase in one go.
+ *
+ * On a flash without erase suspend any erase blocks for the whole sector,
+ * so FlashLog only erases in begin() and format() (at boot, before the
+ * audio starts). Once running it stops recycling: the spare sector takes
+ * FLASH_LOG_PAGES_PER_SECTOR more appends, then write() returns false
+ * until the next boot erases the retired sector.
+ *
+ * begin() scans the region once through the device's memory map and
+ * builds an in-RAM index, so lookups never touch flash.
+ */
+class FlashLog {
+public:
+  explicit FlashLog(const FlashLogDevice& device);
+
+  // Use `sectors` (at least 2) flash sectors starting at byte offset
+  // `flashOffset` from the start of flash. Erases the region if it holds
+  // no valid records. Returns false if the region is unusable.
+  bool begin(uint32_t flashOffset, uint32_t sectors);
+
+  bool isReady() const { return ready; }
+
+  // Newest payload stored for `key` (points into flash), or nullptr
+  const uint8_t* find(uint8_t key, uint16_t* length = nullptr) const;
+
+  // Append unless the stored payload is already identical. Returns true
+  // if the data is stored afterwards.
+  bool write(uint8_t key, const void* data, uint16_t length);
+
+  // No key has a record (a fresh or just formatted region)
+  bool isEmpty() const;
+
+  // Erase every record (blocking)
+  void format();
+
+  // Idle work: one slice of the pending erase, if there is one. Returns
+  // true while there is more to do.
+  bool service();
+  bool isErasePending() const { return pendingErase >= 0 && backgroundErase; }
+
+  // False on a flash without erase suspend (see above)
+  bool canEraseInBackground() const { return backgroundErase; }
+
+  // Counters
+  uint32_t getPagesWritten() const { return pagesWritten; }
+  uint32_t getSectorsErased() const { return sectorsErased; }
+
+private:
+  struct Header {
+    uint16_t magic;
+    uint8_t key;
+    uint8_t reserved;
+    uint32_t sequence;
+    uint16_t length;
+    uint16_t crc;  // Over the header up to here and the payload
+  };
+
+  const Header* pageHeader(uint32_t page) const;
+  bool isValid(uint32_t page) const;
+  bool isErased(uint32_t page) const;
+  bool isSectorErased(uint32_t sector) const;
+
+  bool append(uint8_t key, const uint8_t* data, uint16_t length);
+  void advanceHead();
+  bool recycleSector(uint32_t sector);
+  void finishErase();
+
+  void programPage(uint32_t page, const uint8_t* data);
+  bool eraseSector(uint32_t sector, uint32_t sliceMicros);
+
+  const FlashLogDevice& device;
+  uint32_t baseOffset;
+  uint32_t sectorCount;
+  uint32_t pageCount;
+  uint32_t head;  // Next page to write
+  uint32_t nextSequence;
+  int32_t latest[FLASH_LOG_MAX_KEYS];  // Page of each key's newest record, -1 if none
+  int32_t pendingErase;                // Retired sector still to erase, -1 if none
+  bool backgroundErase;                // Device can suspend an erase
+  bool ready;
+
+  uint32_t pagesWritten;
+  uint32_t sectorsErased;
+
+  uint8_t pageBuffer[FLASH_LOG_PAGE_SIZE];
+};
+
+#endif // BIRDSBOARD_FLASH_LOG_H
@@ -0,0 +1,160 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#if defined(ARDUINO_ARCH_RP2040)
+
+#include "FlashLog.h"
+#include <hardware/flash.h>
+#include <hardware/sync.h>
+#include <hardware/timer.h>
+#include <pico/multicore.h>
+
+static_assert(FLASH_LOG_PAGE_SIZE == FLASH_PAGE_SIZE, "page size mismatch");
+static_assert(FLASH_LOG_SECTOR_SIZE == FLASH_SECTOR_SIZE, "sector size mismatch");
+
+// SPI NOR commands (W25Q and compatible parts)
+#define FLASH_CMD_WRITE_ENABLE 0x06
+#define FLASH_CMD_READ_STATUS 0x05
+#define FLASH_CMD_READ_STATUS_2 0x35
+#define FLASH_CMD_READ_JEDEC_ID 0x9F
+#define FLASH_CMD_SECTOR_ERASE 0x20
+#define FLASH_CMD_ERASE_SUSPEND 0x75
+#define FLASH_CMD_ERASE_RESUME 0x7A
+#define FLASH_STATUS_BUSY 0x01
+#define FLASH_STATUS_2_SUSPENDED 0x80
+
+// JEDEC manufacturers whose parts take the 0x75/0x7A suspend commands and
+// report it in SR2: Winbond, GigaDevice
+#define FLASH_VENDOR_WINBOND 0xEF
+#define FLASH_VENDOR_GIGADEVICE 0xC8
+
+static bool eraseSuspended = false;
+static int8_t suspendSupport = -1;  // Probed on first use
+
+// Flash writes stall XIP for both cores: park the other one in RAM while
+// the flash is busy (multicore lockout, if it called
+// multicore_lockout_victim_init()), and run with interrupts off on this one
+static bool parkOtherCore() {
+  bool park = multicore_lockout_victim_is_initialized(get_core_num() ^ 1);
+  if (park) {
+    multicore_lockout_start_blocking();
+  }
+  return park;
+}
+
+static void releaseOtherCore(bool parked) {
+  if (parked) {
+    multicore_lockout_end_blocking();
+  }
+}
+
+static uint8_t __no_inline_not_in_flash_func(flashStatus)(uint8_t readCommand) {
+  uint8_t command[2];
+  uint8_t status[2];
+  command[0] = readCommand;
+  command[1] = 0;
+  flash_do_cmd(command, status, 2);
+  return status[1];
+}
+
+static bool __no_inline_not_in_flash_func(flashBusy)() {
+  return (flashStatus(FLASH_CMD_READ_STATUS) & FLASH_STATUS_BUSY) != 0;
+}
+
+// From the erase (or resume) command until the flash is idle or suspended
+// nothing can be fetched through XIP, so this and everything it calls
+// run from RAM. Each flash_do_cmd() re-enters XIP when it returns; the
+// last one runs with the flash readable again.
+static bool __no_inline_not_in_flash_func(eraseSlice)(uint32_t offset, uint32_t sliceMicros) {
+  uint8_t command[4];
+  uint8_t reply[4];
+
+  if (eraseSuspended) {
+    command[0] = FLASH_CMD_ERASE_RESUME;
+    flash_do_cmd(command, reply, 1);
+  } else {
+    command[0] = FLASH_CMD_WRITE_ENABLE;
+    flash_do_cmd(command, reply, 1);
+    command[0] = FLASH_CMD_SECTOR_ERASE;
+    command[1] = (uint8_t)(offset >> 16);
+    command[2] = (uint8_t)(offset >> 8);
+    command[3] = (uint8_t)offset;
+    flash_do_cmd(command, reply, 4);
+  }
+
+  uint32_t start = time_us_32();
+  while (flashBusy()) {
+    if (sliceMicros && time_us_32() - start >= sliceMicros) {
+      // Busy clears within the suspend latency (tens of us); only parts
+      // that passed qspiCanSuspend() get here. SR2 tells a suspended erase
+      // from one that finished just before the command.
+      command[0] = FLASH_CMD_ERASE_SUSPEND;
+      flash_do_cmd(command, reply, 1);
+      while (flashBusy()) {
+      }
+      eraseSuspended = (flashStatus(FLASH_CMD_READ_STATUS_2) & FLASH_STATUS_2_SUSPENDED) != 0;
+      return !eraseSuspended;
+    }
+  }
+
+  eraseSuspended = false;
+  return true;
+}
+
+static const uint8_t* qspiRead(uint32_t offset) {
+  return (const uint8_t*)(XIP_BASE + offset);
+}
+
+static void qspiProgram(uint32_t offset, const uint8_t* page) {
+  bool parked = parkOtherCore();
+  uint32_t interrupts = save_and_disable_interrupts();
+
+  flash_range_program(offset, page, FLASH_LOG_PAGE_SIZE);
+
+  restore_interrupts(interrupts);
+  releaseOtherCore(parked);
+}
+
+static bool qspiCanSuspend() {
+  if (suspendSupport < 0) {
+    bool parked = parkOtherCore();
+    uint32_t interrupts = save_and_disable_interrupts();
+
+    uint8_t command[4] = {FLASH_CMD_READ_JEDEC_ID, 0, 0, 0};
+    uint8_t id[4];
+    flash_do_cmd(command, id, 4);
+
+    restore_interrupts(interrupts);
+    releaseOtherCore(parked);
+    suspendSupport = (id[1] == FLASH_VENDOR_WINBOND || id[1] == FLASH_VENDOR_GIGADEVICE) ? 1 : 0;
+  }
+  return suspendSupport > 0;
+}
+
+// A slice on a part without erase suspend would block for the whole
+// sector erase; FlashLog doesn't ask for one, and this refuses it
+static bool qspiErase(uint32_t offset, uint32_t sliceMicros) {
+  if (sliceMicros && !qspiCanSuspend()) {
+    return false;
+  }
+
+  bool parked = parkOtherCore();
+  uint32_t interrupts = save_and_disable_interrupts();
+
+  bool erased = eraseSlice(offset, sliceMicros);
+
+  restore_interrupts(interrupts);
+  releaseOtherCore(parked);
+  return erased;
+}
+
+const FlashLogDevice qspiFlashDevice = {qspiRead, qspiProgram, qspiErase, qspiCanSuspend};
+
+#endif // ARDUINO_ARCH_RP2040
@@ -0,0 +1,123 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_GATE_CAPTURE_H
+#define BIRDSBOARD_GATE_CAPTURE_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * Interrupt-timestamped gate edges for sample-accurate triggers
+ *
+ * A GPIO interrupt on every gate edge pushes the new level and the
+ * microsecond timer into a lock-free single-producer, single-consumer
+ * queue. Once per DMA buffer the render callback gives the time the
+ * buffer's first frame stands for on the sample clock
+ * (AudioOutput::getBlockMicros(): its play-out time less a fixed latency)
+ * and takes the edges that fall in it, each at its sample offset:
+ *
+ *   offset = (edge time - block time) * sample rate
+ *
+ * Every edge sounds the same latency after it arrived, also when buffers
+ * render back to back, and the spacing between edges is kept to the
+ * sample instead of being rounded to a control-rate poll. Edges past the
+ * buffer wait in the queue for theirs; one that arrived too late for its
+ * buffer (a render stalled past the latency) lands on the first frame of
+ * the next. The audio loop itself reads no GPIO.
+ *
+ * Capacity is a power of two; edges that arrive while the queue is full
+ * are dropped and counted. The sketch attaches the interrupt and supplies
+ * the timestamps.
+ */
+template <int Capacity = 32>
+class GateCapture {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "gate queue capacity must be a power of two");
+
+public:
+  // Level the gate is at now, before the interrupt is attached
+  void begin(bool level) {
+    gateLevel = level;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+  }
+
+  // Interrupt side: one edge, `level` read after it
+  void recordEdge(bool level, uint32_t timeMicros) {
+    uint32_t write = tail.load(std::memory_order_relaxed);
+    if (write - head.load(std::memory_order_acquire) >= (uint32_t)Capacity) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    edges[write & (Capacity - 1)] = {timeMicros, level};
+    tail.store(write + 1, std::memory_order_release);
+  }
+
+  // Render side, once per buffer of `frames` samples whose first frame
+  // stands for `blockMicros`
+  void beginBlock(uint32_t blockMicros, int frames, uint32_t sampleRate) {
+    blockStart = blockMicros;
+    blockFrames = frames;
+    rate = sampleRate;
+  }
+
+  // Next rising edge of this buffer, in time order; false once there are
+  // no more. Falling edges only update the level.
+  bool nextRisingEdge(int& offset) {
+    uint32_t read = head.load(std::memory_order_relaxed);
+    while (read != tail.load(std::memory_order_acquire)) {
+      Edge edge = edges[read & (Capacity - 1)];
+      int edgeOffset = sampleOffset(edge.timeMicros);
+      if (edgeOffset >= blockFrames) {
+        break;  // Belongs to a later buffer
+      }
+      head.store(++read, std::memory_order_release);
+
+      bool rising = edge.level && !gateLevel;
+      gateLevel = edge.level;
+      if (rising) {
+        offset = edgeOffset;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool level() const { return gateLevel; }
+  uint32_t getDroppedEdges() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+  struct Edge {
+    uint32_t timeMicros;
+    bool level;
+  };
+
+  // Late edges (before the buffer) on its first frame; past the end
+  // anything from blockFrames on
+  int sampleOffset(uint32_t timeMicros) const {
+    int32_t elapsed = (int32_t)(timeMicros - blockStart);
+    if (elapsed <= 0) return 0;
+
+    uint64_t offset = ((uint64_t)elapsed * rate) / 1000000u;
+    return offset < (uint64_t)blockFrames ? (int)offset : blockFrames;
+  }
+
+  Edge edges[Capacity];
+  std::atomic<uint32_t> head{0};  // Written by the renderer
+  std::atomic<uint32_t> tail{0};  // Written by the interrupt
+  std::atomic<uint32_t> dropped{0};
+
+  bool gateLevel = false;
+  uint32_t blockStart = 0;
+  int blockFrames = 1;
+  uint32_t rate = 44100;
+};
+
+#endif // BIRDSBOARD_GATE_CAPTURE_H
@@ -0,0 +1,139 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_TABLES_H
+#define BIRDSBOARD_TABLES_H
+
+#include <stdint.h>
+
+/**
+ * Compile-time lookup table generation
+ *
+ * Sine, saw, triangle and pulse tables of any power-of-two size, built by
+ * the compiler and placed in flash like a hand-pasted literal table, with
+ * no startup cost and no RAM copy. The generators only run in constant
+ * expressions, so the double arithmetic below never reaches the target.
+ */
+
+enum TableShape {
+  TABLE_SINE = 0,
+  TABLE_SAW = 1,       // Rising ramp, -1 to +1
+  TABLE_TRIANGLE = 2,  // 0 at phase 0, +1 at 1/4, -1 at 3/4
+  TABLE_PULSE = 3,     // +1 for the first `duty` of the cycle, -1 after
+};
+
+namespace tables {
+
+constexpr double TWO_PI = 6.283185307179586;
+
+// sin(x) by range reduction to [-pi, pi] and its Taylor series
+constexpr double sine(double x) {
+  while (x > TWO_PI / 2) x -= TWO_PI;
+  while (x < -TWO_PI / 2) x += TWO_PI;
+
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 14; n++) {
+    term *= -x * x / ((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+// One cycle of `shape` at `phase` (0 to 1), -1 to +1
+constexpr double shapeValue(TableShape shape, double phase, double duty) {
+  switch (shape) {
+    case TABLE_SINE:
+      return sine(TWO_PI * phase);
+    case TABLE_SAW:
+      return 2.0 * phase - 1.0;
+    case TABLE_TRIANGLE:
+      if (phase < 0.25) return 4.0 * phase;
+      if (phase < 0.75) return 2.0 - 4.0 * phase;
+      return 4.0 * phase - 4.0;
+    case TABLE_PULSE:
+    default:
+      return (phase < duty) ? 1.0 : -1.0;
+  }
+}
+
+constexpr int32_t roundToInt(double x) {
+  return (int32_t)(x < 0.0 ? x - 0.5 : x + 0.5);
+}
+
+}  // namespace tables
+
+template <typename T, int Size>
+struct LookupTable {
+  static_assert(Size > 0 && (Size & (Size - 1)) == 0, "table size must be a power of two");
+  static constexpr int size = Size;
+  static constexpr int mask = Size - 1;
+
+  T values[Size];
+
+  constexpr T operator[](int index) const { return values[index]; }
+};
+
+// Float table with the step to the next entry stored beside each value,
+// so a lookup is one multiply-add (the last step wraps to entry 0)
+template <int Size>
+struct InterpolatedTable {
+  static_assert(Size > 0 && (Size & (Size - 1)) == 0, "table size must be a power of two");
+  static constexpr int size = Size;
+  static constexpr int mask = Size - 1;
+
+  float values[Size];
+  float slopes[Size];
+
+  // `phase` 0 to 1 (not wrapped here)
+  float lookup(float phase) const {
+    float position = phase * Size;
+    int index = (int)position;
+    float frac = position - (float)index;
+    index &= mask;
+    return values[index] + frac * slopes[index];
+  }
+};
+
+// Signed 16-bit table, full scale +/-32767
+template <int Size>
+constexpr LookupTable<int16_t, Size> makeInt16Table(TableShape shape, double duty = 0.5) {
+  LookupTable<int16_t, Size> table = {};
+  for (int i = 0; i < Size; i++) {
+    table.values[i] = (int16_t)tables::roundToInt(32767.0 * tables::shapeValue(shape, (double)i / Size, duty));
+  }
+  return table;
+}
+
+// Unsigned 16-bit table in the DAC format the Wren wavetables use
+// (32768 = centre, 1 to 65535 full scale)
+template <int Size>
+constexpr LookupTable<uint16_t, Size> makeUint16Table(TableShape shape, double duty = 0.5) {
+  LookupTable<uint16_t, Size> table = {};
+  for (int i = 0; i < Size; i++) {
+    table.values[i] = (uint16_t)(32768 + tables::roundToInt(32767.0 * tables::shapeValue(shape, (double)i / Size, duty)));
+  }
+  return table;
+}
+
+// Float table with precomputed slopes, -1 to +1
+template <int Size>
+constexpr InterpolatedTable<Size> makeInterpolatedTable(TableShape shape, double duty = 0.5) {
+  InterpolatedTable<Size> table = {};
+  for (int i = 0; i < Size; i++) {
+    double value = tables::shapeValue(shape, (double)i / Size, duty);
+    double next = tables::shapeValue(shape, (double)((i + 1) % Size) / Size, duty);
+    table.values[i] = (float)value;
+    table.slopes[i] = (float)(next - value);
+  }
+  return table;
+}
+
+#endif // BIRDSBOARD_TABLES_H
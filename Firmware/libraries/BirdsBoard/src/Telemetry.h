@@ -0,0 +1,234 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_TELEMETRY_H
+#define BIRDSBOARD_TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include "Crc.h"
+
+/**
+ * On-target render telemetry
+ *
+ * The audio core times each render block with the CPU cycle counter and
+ * records min/avg/max cycles per sample into one of `Slots` buckets (an
+ * algorithm, a modulation type), plus the control-loop latency. The other
+ * core takes a snapshot of the interval since its last one and streams it
+ * as a CRC framed binary record:
+ *
+ *   <TELEMETRY_FRAME_TYPE> <length:2> <payload> <crc16:2>
+ *
+ * Little endian, CRC-16/CCITT-FALSE over length and payload, the same
+ * framing as Wren's bulk transfers. Payload:
+ *
+ *   u8 version, u8 slots, u16 block frames, u32 sample rate, u32 CPU Hz,
+ *   u32 blocks, u32 I2S underruns (since boot),
+ *   u32 control latency min/avg/max cycles,
+ *   then per slot: u32 samples, u32 min/avg/max cycles per sample
+ *
+ * Recording costs the audio core a few counter reads and compares per
+ * block and never waits on the other core. Sketches compile it in behind
+ * their own TELEMETRY define.
+ */
+
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_FRAME_TYPE 0xAC  // Also Wren's RESP_TELEMETRY
+#define TELEMETRY_HEADER_BYTES 32
+#define TELEMETRY_SLOT_BYTES 16
+#define TELEMETRY_FRAME_SIZE(slots) (1 + 2 + TELEMETRY_HEADER_BYTES + (slots) * TELEMETRY_SLOT_BYTES + 2)
+#define TELEMETRY_PERIOD_MS 250  // Frame interval for sketches that stream over USB CDC
+
+// CPU cycle counter of the calling core. RP2350 only: the Cortex-M33 DWT
+// counter, or mcycle on the Hazard3 RISC-V cores. Elsewhere it reads 0.
+#if defined(__ARM_ARCH_8M_MAIN__)
+#define TELEMETRY_DEMCR (*(volatile uint32_t*)0xE000EDFC)
+#define TELEMETRY_DWT_CTRL (*(volatile uint32_t*)0xE0001000)
+#define TELEMETRY_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004)
+
+inline void cycleCounterBegin() {
+  TELEMETRY_DEMCR |= (1UL << 24);  // TRCENA
+  TELEMETRY_DWT_CYCCNT = 0;
+  TELEMETRY_DWT_CTRL |= 1UL;  // CYCCNTENA
+}
+
+inline uint32_t cycleCount() {
+  return TELEMETRY_DWT_CYCCNT;
+}
+#elif defined(__riscv)
+inline void cycleCounterBegin() {
+  asm volatile("csrci mcountinhibit, 1");  // Let mcycle count
+}
+
+inline uint32_t cycleCount() {
+  uint32_t cycles;
+  asm volatile("csrr %0, mcycle" : "=r"(cycles));
+  return cycles;
+}
+#else
+inline void cycleCounterBegin() {
+}
+
+inline uint32_t cycleCount() {
+  return 0;
+}
+#endif
+
+// Min/avg/max of a cycle cost over `count` units (samples or events)
+struct CycleStats {
+  uint32_t count;
+  uint32_t minCycles;  // Per unit
+  uint32_t maxCycles;
+  uint64_t totalCycles;
+
+  void reset() {
+    count = 0;
+    minCycles = UINT32_MAX;
+    maxCycles = 0;
+    totalCycles = 0;
+  }
+
+  // `cycles` spent on `units` units
+  void record(uint32_t cycles, uint32_t units) {
+    uint32_t perUnit = cycles / units;
+    if (perUnit < minCycles) minCycles = perUnit;
+    if (perUnit > maxCycles) maxCycles = perUnit;
+    totalCycles += cycles;
+    count += units;
+  }
+
+  uint32_t averageCycles() const {
+    return count ? (uint32_t)(totalCycles / count) : 0;
+  }
+};
+
+template <int Slots>
+class Telemetry {
+public:
+  static constexpr int slots = Slots;
+  static constexpr size_t frameSize = TELEMETRY_FRAME_SIZE(Slots);
+
+  // Call on the audio core, which owns the cycle counter being read
+  void begin() {
+    cycleCounterBegin();
+    current.reset();
+    state.store(STATE_IDLE, std::memory_order_relaxed);
+  }
+
+  // Audio core: control inputs read to applied, in cycles
+  void recordControlLatency(uint32_t cycles) {
+    current.control.record(cycles, 1);
+  }
+
+  // Audio core: one rendered block, then hand the interval over if the
+  // other core asked for it
+  void recordBlock(uint8_t slot, uint32_t cycles, uint32_t frames) {
+    if (slot < Slots && frames > 0) {
+      current.slot[slot].record(cycles, frames);
+      current.blockFrames = (uint16_t)frames;
+    }
+    current.blocks++;
+
+    if (state.load(std::memory_order_acquire) == STATE_REQUESTED) {
+      published = current;
+      current.reset();
+      state.store(STATE_READY, std::memory_order_release);
+    }
+  }
+
+  // Reporting core: asks for the interval since the last frame and returns
+  // true once `frame` (frameSize bytes) holds it, normally on the next
+  // call after the audio core's next block
+  bool poll(uint8_t* frame, uint32_t underruns, uint32_t sampleRate, uint32_t cpuHz) {
+    uint8_t now = state.load(std::memory_order_acquire);
+    if (now == STATE_IDLE) {
+      state.store(STATE_REQUESTED, std::memory_order_release);
+      return false;
+    }
+    if (now != STATE_READY) {
+      return false;
+    }
+
+    encode(frame, underruns, sampleRate, cpuHz);
+    state.store(STATE_IDLE, std::memory_order_release);
+    return true;
+  }
+
+private:
+  enum {
+    STATE_IDLE = 0,
+    STATE_REQUESTED,  // Audio core publishes after its next block
+    STATE_READY       // `published` holds the interval
+  };
+
+  struct Interval {
+    uint32_t blocks;
+    uint16_t blockFrames;
+    CycleStats control;
+    CycleStats slot[Slots];
+
+    void reset() {
+      blocks = 0;
+      blockFrames = 0;
+      control.reset();
+      for (int s = 0; s < Slots; s++) {
+        slot[s].reset();
+      }
+    }
+  };
+
+  Interval current;    // Audio core only
+  Interval published;  // Written by the audio core in STATE_REQUESTED, read in STATE_READY
+  std::atomic<uint8_t> state;
+
+  static uint8_t* put16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+    return out + 2;
+  }
+
+  static uint8_t* put32(uint8_t* out, uint32_t value) {
+    out = put16(out, (uint16_t)value);
+    return put16(out, (uint16_t)(value >> 16));
+  }
+
+  // An empty stats bucket reports zeros rather than UINT32_MAX
+  static uint8_t* putStats(uint8_t* out, const CycleStats& stats) {
+    out = put32(out, stats.count ? stats.minCycles : 0);
+    out = put32(out, stats.averageCycles());
+    return put32(out, stats.maxCycles);
+  }
+
+  void encode(uint8_t* frame, uint32_t underruns, uint32_t sampleRate, uint32_t cpuHz) const {
+    const uint16_t length = (uint16_t)(frameSize - 5);
+
+    uint8_t* out = frame;
+    *out++ = TELEMETRY_FRAME_TYPE;
+    out = put16(out, length);
+    *out++ = TELEMETRY_VERSION;
+    *out++ = Slots;
+    out = put16(out, published.blockFrames);
+    out = put32(out, sampleRate);
+    out = put32(out, cpuHz);
+    out = put32(out, published.blocks);
+    out = put32(out, underruns);
+    out = putStats(out, published.control);
+
+    for (int s = 0; s < Slots; s++) {
+      out = put32(out, published.slot[s].count);
+      out = putStats(out, published.slot[s]);
+    }
+
+    put16(out, crc16(frame + 1, 2 + length));
+  }
+};
+
+#endif // BIRDSBOARD_TELEMETRY_H
@@ -0,0 +1,1167 @@
+/*
+ * BirdsBoard shared firmware library
+ * Copyright (C) 2025 Leo Kuroshita
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BIRDSBOARD_TOCKUS_ENGINE_H
+#define BIRDSBOARD_TOCKUS_ENGINE_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "FixedPoint.h"
+#include "Oversampling.h"
+
+/**
+ * Tockus drum voice engine
+ *
+ * The whole Tockus sound: eight drum algorithms on a pool of voices, the
+ * shared output stage and the real-time pitch tracking. The firmware and
+ * the desktop simulator both render through this header, so a change is
+ * benchmarked on the desktop exactly as it will run on the RP2350.
+ *
+ * Sample rate, output sample type (int16_t for the DAC, float for the
+ * simulator), control block size and voice count are template
+ * parameters, so nothing about the configuration is paid for at run
+ * time. FixedPointDsp selects the Q31 envelopes and biquads of
+ * FixedPoint.h.
+ *
+ * Voices are stored structure-of-arrays and grouped by algorithm every
+ * block, so each generator renders all of its voices in one tight loop.
+ *
+ * The Oversampling policy renders chosen algorithms (the aliasing ones:
+ * ZAP's saw, the hi-hat and cowbell pulses) at 2x or 4x the sample rate
+ * into a mix of their own, decimated back by Oversampling.h's half-band
+ * filters. The other algorithms keep rendering at the base rate, and the
+ * decimator only runs while an oversampled voice rings.
+ *
+ * MODAL and COWBELL ring from a ResonatorBank: complex rotators that need
+ * only multiplies per sample, four lanes at a time. ModalModes (4, 8 or
+ * 16) sets how many modes a MODAL hit rings, so the richer bell spectra
+ * are a compile-time choice with a compile-time cost.
+ */
+
+// Tockus hardware configuration, shared so the simulator renders what
+// the firmware does
+#define TOCKUS_SAMPLE_RATE 44100
+#define TOCKUS_BLOCK_SIZE  4  // Control rate: CV snapshot and gate read every 4 samples
+#define TOCKUS_VOICES      4  // Overlapping hits before the quietest is stolen
+
+// Karplus-Strong delay line: a power of two, longer than the loop at the
+// lowest KARPLUS pitch (551 samples for 80Hz at 44.1kHz)
+#define KARPLUS_MIN_FREQUENCY 80.0f
+#define KARPLUS_BUFFER_SIZE 1024
+#define MAX_MODAL_MODES 16
+
+// Resonators are silenced above this fraction of the sample rate rather
+// than left to alias
+#define RESONATOR_MAX_CYCLES 0.45f
+
+// Filter coefficients are only recomputed when cutoff/center frequency
+// moves by more than this fraction (or Q changes)
+#define COEFF_TOLERANCE 0.001f
+
+// Drum algorithms (CV1 order)
+enum DrumAlgorithm {
+  ALGO_BASS = 0,      // 808 Bass drum
+  ALGO_SNARE = 1,     // 808 Snare drum
+  ALGO_HIHAT = 2,     // 808 Hi-hat
+  ALGO_KARPLUS = 3,   // Karplus-Strong
+  ALGO_MODAL = 4,     // Modal synthesis
+  ALGO_ZAP = 5,       // ZAP sound
+  ALGO_CLAP = 6,      // 808 Clap
+  ALGO_COWBELL = 7,   // Cowbell (four pulse oscillators)
+  NUM_ALGORITHMS = 8
+};
+
+// Trigger clock source for envelope timing
+enum TriggerClock {
+  CLOCK_SAMPLES = 0,  // Sample counter (sample-accurate, deterministic)
+  CLOCK_SYSTEM = 1,   // Milliseconds passed in through setClockMs()
+};
+
+// Recursive envelope generators - one multiply per sample, coefficients
+// computed once at trigger time so the render loop never calls exp()
+
+// Exponential decay: value(n) = exp(-rate * n / sampleRate)
+struct DecayEnvelope {
+  float value = 0.0f;
+  float coeff = 0.0f;
+
+  void trigger(float rate, float samplePeriod) {
+    value = 1.0f;
+    coeff = expf(-rate * samplePeriod);
+  }
+
+  void restart() { value = 1.0f; }
+
+  // Returns the current value and advances one sample
+  float process() {
+    float out = value;
+    value *= coeff;
+    return out;
+  }
+};
+
+// The same envelope on the Q31 recursion
+struct DecayEnvelopeFixed {
+  DecayEnvelopeQ31 q31 = { 0, 0 };
+
+  void trigger(float rate, float samplePeriod) { q31.trigger(expf(-rate * samplePeriod)); }
+  void restart() { q31.restart(); }
+  float process() { return q31ToFloat(q31.process()); }
+};
+
+// Train of identical decaying pulses (808 clap): `count` pulses, each
+// `width` samples long, starting every `spacing` samples
+template <typename Envelope>
+struct PulseTrainEnvelope {
+  Envelope pulse;
+  int spacing = 0;
+  int width = 0;
+  int pulsesLeft = 0;
+  int position = 0;  // Samples since the current pulse started
+
+  void trigger(int count, float spacingSeconds, float widthSeconds, float rate, float samplePeriod) {
+    spacing = (int)(spacingSeconds / samplePeriod + 0.5f);
+    width = (int)(widthSeconds / samplePeriod + 0.5f);
+    pulsesLeft = count;
+    position = 0;
+    pulse.trigger(rate, samplePeriod);
+  }
+
+  float process() {
+    if (pulsesLeft <= 0) return 0.0f;
+
+    float out = (position <= width) ? pulse.process() : 0.0f;
+    if (++position >= spacing) {
+      position = 0;
+      if (--pulsesLeft > 0) pulse.restart();
+    }
+    return out;
+  }
+};
+
+// Decaying sine oscillators, one complex rotator per lane:
+// z <- z * r e^(jw) is four multiplies and never calls sinf. Lanes are
+// structure-of-arrays with no branches in the sample loop, so the desktop
+// build runs it as SSE/NEON vectors (Lanes is a multiple of 4).
+template <int Lanes>
+struct ResonatorBank {
+  static_assert(Lanes % 4 == 0, "resonator lanes come in groups of 4");
+
+  float re[Lanes];
+  float im[Lanes];      // Output: amplitude * r^n * sin(n w)
+  float cosine[Lanes];  // r cos(w)
+  float sine[Lanes];    // r sin(w)
+  float decay[Lanes];   // r, amplitude kept per sample
+
+  // Lane `i` restarts at phase 0 and `amplitude`. Call tune() after.
+  void start(int i, float amplitude, float perSample) {
+    re[i] = amplitude;
+    im[i] = 0.0f;
+    decay[i] = perSample;
+  }
+
+  // Lane `i` at `cycles` per sample (frequency * sample period), without
+  // a phase jump. A lane at or above RESONATOR_MAX_CYCLES is silent until
+  // its next start().
+  void tune(int i, float cycles) {
+    if (cycles >= RESONATOR_MAX_CYCLES) {
+      cosine[i] = 0.0f;
+      sine[i] = 0.0f;
+      return;
+    }
+    float w = 6.28318531f * cycles;
+    cosine[i] = decay[i] * cosf(w);
+    sine[i] = decay[i] * sinf(w);
+  }
+
+  // Sum of the lanes' current outputs, then one sample on
+  float processSine() {
+    float sum = 0.0f;
+    for (int i = 0; i < Lanes; i++) {
+      sum += im[i];
+      float nextRe = re[i] * cosine[i] - im[i] * sine[i];
+      im[i] = re[i] * sine[i] + im[i] * cosine[i];
+      re[i] = nextRe;
+    }
+    return sum;
+  }
+
+  // One sample on, then the sign of each lane as a +/-weights[i] pulse
+  // (50% duty cycle)
+  float processPulse(const float* weights) {
+    float sum = 0.0f;
+    for (int i = 0; i < Lanes; i++) {
+      float nextRe = re[i] * cosine[i] - im[i] * sine[i];
+      im[i] = re[i] * sine[i] + im[i] * cosine[i];
+      re[i] = nextRe;
+      sum += (im[i] > 0.0f) ? weights[i] : -weights[i];
+    }
+    return sum;
+  }
+};
+
+// Biquad state with the parameters its coefficients were computed for
+struct DrumFilter {
+  float x1, x2;  // Input delay line
+  float y1, y2;  // Output delay line
+  float frequency;  // Bandpass center or resonant cutoff
+  float Q;          // Bandpass Q or resonance
+  bool dirty;       // Force recompute on init
+  float period;     // Sample period the coefficients were computed for
+  float a0, a1, a2, b1, b2;  // Filter coefficients
+  BiquadQ31 q31;    // Integer recursion, coefficients mirrored from above
+};
+
+// Timing hooks around each algorithm's pass in render(). The default
+// compiles away; the simulator's profiler plugs in its own.
+struct NullRenderProbe {
+  void algorithmStarted(uint8_t algorithm) { (void)algorithm; }
+  void algorithmFinished(uint8_t algorithm, int frames) { (void)algorithm; (void)frames; }
+};
+
+#define ALGORITHM_BIT(algorithm) (1u << (algorithm))
+
+// Oversampling policy: the algorithms whose ALGORITHM_BIT is set in
+// `Algorithms` render at Factor (2 or 4) times the sample rate
+template <int Factor, unsigned Algorithms>
+struct OversampleAlgorithms {
+  static constexpr int factor = Factor;
+  static constexpr unsigned algorithms = Algorithms;
+};
+
+typedef OversampleAlgorithms<1, 0> NoOversampling;
+
+// The algorithms with naive (aliasing) oscillators
+#define TOCKUS_ALIASING_ALGORITHMS (ALGORITHM_BIT(ALGO_HIHAT) | ALGORITHM_BIT(ALGO_ZAP) | ALGORITHM_BIT(ALGO_COWBELL))
+
+template <int SampleRate, typename Sample, int BlockSize, int MaxVoices = TOCKUS_VOICES, bool FixedPointDsp = false,
+          typename Probe = NullRenderProbe, typename Oversampling = NoOversampling, int ModalModes = 4>
+class TockusEngine {
+  static_assert(ModalModes == 4 || ModalModes == 8 || ModalModes == MAX_MODAL_MODES, "modal modes must be 4, 8 or 16");
+  static_assert(Oversampling::factor == 1 || Oversampling::factor == 2 || Oversampling::factor == 4,
+                "oversampling factor must be 1, 2 or 4");
+  static_assert(Oversampling::factor == 1 || !(Oversampling::algorithms & ALGORITHM_BIT(ALGO_KARPLUS)),
+                "the Karplus-Strong delay line is sized for the base rate");
+  static_assert(SampleRate / KARPLUS_MIN_FREQUENCY + 2.0f < KARPLUS_BUFFER_SIZE,
+                "KARPLUS_BUFFER_SIZE must hold the loop at KARPLUS_MIN_FREQUENCY");
+  static_assert((KARPLUS_BUFFER_SIZE & (KARPLUS_BUFFER_SIZE - 1)) == 0, "KARPLUS_BUFFER_SIZE must be a power of two");
+
+public:
+  static constexpr int sampleRate = SampleRate;
+  static constexpr int blockSize = BlockSize;
+  static constexpr int maxVoices = MaxVoices;
+  static constexpr float samplePeriod = 1.0f / SampleRate;
+
+  TockusEngine() { reset(); }
+
+  // Silence every voice and return to the power-on state
+  void reset() {
+    memset((void*)&voices, 0, sizeof(voices));
+    triggerClock = CLOCK_SAMPLES;
+    clockMs = 0;
+    currentAlgorithm = ALGO_BASS;
+    frequency = 60.0f;
+    currentFrequency = 60.0f;
+    algorithmParam = 0.5f;
+    sampleCount = 0;
+    lastSample = 0.0f;
+    decimator.reset();
+    decimatorTail = 0;
+
+    // Initialize every voice up front - nothing is set up while rendering
+    for (int v = 0; v < MaxVoices; v++) {
+      voices.currentFrequency[v] = currentFrequency;
+      voices.karplusDamping[v] = 0.99f;
+      voices.karplusWrite[v] = 0;
+      for (int i = 0; i < KARPLUS_BUFFER_SIZE; i++) {
+        voices.karplusBuffer[v][i] = 0.0f;
+      }
+      voices.noiseState[v] = 1;
+
+      initializeFilter(voices.bpf[v]);
+      setBandpassFilter(voices.bpf[v], 8000.0f, 2.0f, samplePeriod);  // Default: 8kHz, Q=2
+      initializeFilter(voices.bassFilter[v]);
+      updateResonantFilter(voices.bassFilter[v], 80.0f, 10.0f, samplePeriod);
+      initializeKarplusStrong(v);
+      setupModalModes(v);
+      setupCowbell(v);
+    }
+  }
+
+  void setTriggerClock(TriggerClock clock) { triggerClock = clock; }
+  TriggerClock getTriggerClock() const { return triggerClock; }
+
+  // CLOCK_SYSTEM only: the current time, set before each render()
+  void setClockMs(uint32_t ms) { clockMs = ms; }
+
+  // Controls for the next trigger and for every ringing voice's pitch.
+  // `newFrequency` is already scaled for the selected algorithm; each
+  // voice scales it again for its own algorithm.
+  void setControls(float newFrequency, uint8_t algorithm, float parameter) {
+    frequency = newFrequency;
+    currentAlgorithm = (algorithm < NUM_ALGORITHMS) ? algorithm : NUM_ALGORITHMS - 1;
+    algorithmParam = parameter;
+  }
+
+  // Start a hit of the selected algorithm on a free (or stolen) voice
+  void trigger() {
+    int v = allocateVoice();
+
+    voices.active[v] = true;
+    voices.algorithm[v] = currentAlgorithm;
+    voices.startSample[v] = sampleCount;
+    voices.startTime[v] = clockMs;
+    voices.currentFrequency[v] = frequency;
+
+    // Initialize envelopes based on algorithm
+    initializeEnvelopes(v);
+
+    // Reset noise state
+    voices.noiseState[v] = 1;
+  }
+
+  // Fill `out` with `frames` samples, in control blocks of BlockSize
+  void render(Sample* out, int frames) {
+    for (int offset = 0; offset < frames; offset += BlockSize) {
+      int chunk = (frames - offset < BlockSize) ? frames - offset : BlockSize;
+
+      float mix[BlockSize];
+      renderVoiceMix(mix, chunk);
+
+      for (int frame = 0; frame < chunk; frame++) {
+        out[offset + frame] = toSample(applyOutputStage(mix[frame]));
+      }
+    }
+  }
+
+  uint8_t getAlgorithm() const { return currentAlgorithm; }
+  float getFrequency() const { return currentFrequency; }
+  uint32_t getSampleCount() const { return sampleCount; }
+
+  int getActiveVoiceCount() const {
+    int count = 0;
+    for (int v = 0; v < MaxVoices; v++) {
+      count += voices.active[v] ? 1 : 0;
+    }
+    return count;
+  }
+
+  // Loudest active voice's amplitude envelope
+  float getPeakAmplitude() const {
+    float amplitude = 0.0f;
+    for (int v = 0; v < MaxVoices; v++) {
+      if (voices.active[v] && voices.envAmplitude[v] > amplitude) {
+        amplitude = voices.envAmplitude[v];
+      }
+    }
+    return amplitude;
+  }
+
+  // Per-algorithm timing hooks (see NullRenderProbe)
+  Probe& getProbe() { return probe; }
+
+  // Apply algorithm-specific frequency scaling and range
+  static float scaleFrequency(float baseFreq, uint8_t algorithm) {
+    switch (algorithm) {
+      case ALGO_BASS:
+        return clampf(baseFreq / 4.0f, 20.0f, 150.0f);     // -2 octaves, 20-150Hz
+      case ALGO_SNARE:
+        return clampf(baseFreq / 2.0f, 100.0f, 400.0f);    // -1 octave, 100-400Hz
+      case ALGO_HIHAT:
+        return clampf(baseFreq, 200.0f, 2000.0f);          // No shift, 200-2000Hz
+      case ALGO_KARPLUS:
+        return clampf(baseFreq / 2.0f, KARPLUS_MIN_FREQUENCY, 800.0f);  // -1 octave, 80-800Hz
+      case ALGO_MODAL:
+        return clampf(baseFreq * 4.0f, 240.0f, 2400.0f);   // +2 octaves, 240-2400Hz
+      case ALGO_ZAP:
+        return clampf(baseFreq / 2.8f, 50.0f, 500.0f);     // -1.5 octaves, 50-500Hz
+      case ALGO_CLAP:
+        return clampf(baseFreq, 150.0f, 1500.0f);          // No shift (noise-based), 150-1500Hz
+      case ALGO_COWBELL:
+        return clampf(baseFreq * 4.0f, 2000.0f, 8000.0f);  // +2 octaves, 2000-8000Hz
+      default:
+        return clampf(baseFreq, 20.0f, 8000.0f);
+    }
+  }
+
+private:
+  typedef typename std::conditional<FixedPointDsp, DecayEnvelopeFixed, DecayEnvelope>::type Envelope;
+
+  // Preallocated voice pool, structure-of-arrays (indexed by voice)
+  struct VoicePool {
+    bool active[MaxVoices];
+    uint8_t algorithm[MaxVoices];
+    uint32_t startSample[MaxVoices];
+    uint32_t startTime[MaxVoices];  // ms, CLOCK_SYSTEM only
+
+    // Envelope parameters
+    float currentFrequency[MaxVoices];
+    float envAmplitude[MaxVoices];
+    float envFrequency[MaxVoices];
+    float envDecayRate[MaxVoices];
+
+    // Noise generator state
+    uint32_t noiseState[MaxVoices];
+
+    // Algorithm-specific parameters
+    float snareNoiseAmp[MaxVoices];
+    float snareToneAmp[MaxVoices];
+    float hihatEnvelope[MaxVoices];
+    float clapPulseEnv[MaxVoices];
+    float clapReverbEnv[MaxVoices];
+    float bassImpulse[MaxVoices];
+    ResonatorBank<4> cowbell[MaxVoices];  // The four 808 oscillators, undamped
+
+    // Recursive envelopes (coefficients computed at trigger time)
+    Envelope ampEnv[MaxVoices];
+    Envelope pitchEnvelope[MaxVoices];  // BASS/ZAP pitch sweep
+    Envelope snareNoiseEnv[MaxVoices];
+    Envelope snarePitchEnv[MaxVoices];
+    Envelope bassCutoffEnv[MaxVoices];
+    Envelope zapSweepEnv[MaxVoices];
+    Envelope clapReverbEnvelope[MaxVoices];
+    PulseTrainEnvelope<Envelope> clapPulses[MaxVoices];
+
+    // Filter instances
+    DrumFilter bpf[MaxVoices];
+    DrumFilter bassFilter[MaxVoices];  // Self-oscillating 2-pole resonant lowpass
+
+    // Karplus-Strong delay lines. The loop is karplusDelay whole samples,
+    // half a sample in the averaging lowpass and the all-pass fraction.
+    float karplusBuffer[MaxVoices][KARPLUS_BUFFER_SIZE];
+    int karplusWrite[MaxVoices];
+    int karplusDelay[MaxVoices];
+    int karplusBurst[MaxVoices];       // Excitation samples still to write
+    float karplusAllpass[MaxVoices];   // Fractional delay coefficient
+    float karplusLast[MaxVoices];      // Averaging lowpass state
+    float karplusAllpassX[MaxVoices];  // All-pass state
+    float karplusAllpassY[MaxVoices];
+    float karplusDamping[MaxVoices];
+
+    // Modal synthesis modes, tuned for modalFrequency
+    ResonatorBank<ModalModes> modes[MaxVoices];
+    float modalFrequency[MaxVoices];
+  };
+
+  static constexpr float TWO_PI_F = 6.28318531f;
+  static constexpr float MASTER_GAIN = 2.0f;
+  static constexpr float LOWPASS_ALPHA = 0.7f;  // Anti-aliasing lowpass, cutoff around 6kHz
+
+  // Modal synthesis: inharmonic drum ratios, amplitudes decreasing and
+  // decay rates increasing with frequency. A build plays the first
+  // ModalModes; the ones past 4 are the denser, bell-like upper partials.
+  static constexpr float modalRatios[MAX_MODAL_MODES] = {
+    1.0f, 1.6f, 2.3f, 3.1f, 3.65f, 4.06f, 4.6f, 5.13f,
+    5.4f, 5.95f, 6.5f, 7.05f, 7.6f, 8.2f, 8.8f, 9.4f,
+  };
+  static constexpr float modalAmplitudes[MAX_MODAL_MODES] = {
+    1.0f, 0.7f, 0.5f, 0.3f, 0.28f, 0.24f, 0.2f, 0.17f,
+    0.15f, 0.13f, 0.11f, 0.1f, 0.09f, 0.08f, 0.07f, 0.06f,
+  };
+  static constexpr float modalDecayRatios[MAX_MODAL_MODES] = {
+    1.0f, 1.3f, 1.8f, 2.5f, 2.8f, 3.2f, 3.6f, 4.0f,
+    4.5f, 5.0f, 5.5f, 6.0f, 6.5f, 7.0f, 7.5f, 8.0f,
+  };
+
+  static constexpr float modalAmplitudeSum(int modes) {
+    return modes > 0 ? modalAmplitudes[modes - 1] + modalAmplitudeSum(modes - 1) : 0.0f;
+  }
+
+  // Any mode count plays at the level of the original four (0.25 of them)
+  static constexpr float modalGain = 0.25f * modalAmplitudeSum(4) / modalAmplitudeSum(ModalModes);
+
+  // 808 cowbell: oscillators at 555, 835, 1370 and 1940 Hz with 1/n weights
+  static constexpr float cowbellPeriod =
+      samplePeriod / ((Oversampling::algorithms & ALGORITHM_BIT(ALGO_COWBELL)) ? Oversampling::factor : 1);
+  static constexpr float cowbellFrequencies[4] = { 555.0f, 835.0f, 1370.0f, 1940.0f };
+  static constexpr float cowbellWeights[4] = { 1.0f, 1.0f / 2.0f, 1.0f / 3.0f, 1.0f / 4.0f };
+
+  TriggerClock triggerClock;
+  uint32_t clockMs;
+
+  // Current controls
+  uint8_t currentAlgorithm;
+  float frequency;         // Scaled for the selected algorithm
+  float currentFrequency;  // ... and scaled again, for display
+  float algorithmParam;
+
+  uint32_t sampleCount;
+  float lastSample;  // Anti-aliasing lowpass state
+
+  // Oversampled algorithms' mix back to the output rate, and the output
+  // frames it still has to run on silence before its filters are empty
+  Decimator<float, Oversampling::factor> decimator;
+  int decimatorTail;
+
+  VoicePool voices;
+  Probe probe;
+
+  static float clampf(float value, float low, float high) {
+    return (value < low) ? low : (value > high) ? high : value;
+  }
+
+  // Rate multiplier and sample period an algorithm renders at
+  static constexpr int oversampleFactor(uint8_t algorithm) {
+    return (Oversampling::algorithms & ALGORITHM_BIT(algorithm)) ? Oversampling::factor : 1;
+  }
+
+  static constexpr float algorithmPeriod(uint8_t algorithm) {
+    return samplePeriod / oversampleFactor(algorithm);
+  }
+
+  static Sample toSample(float sample) {
+    if constexpr (std::is_floating_point<Sample>::value) {
+      return (Sample)sample;
+    } else {
+      return (Sample)(sample * 32767.0f);
+    }
+  }
+
+  // Per-algorithm output gain, to prevent clipping (indexed by DrumAlgorithm)
+  static float algorithmGain(uint8_t algorithm) {
+    static const float gains[NUM_ALGORITHMS] = {
+      1.0f,  // ALGO_BASS
+      0.4f,  // ALGO_SNARE - reduce gain significantly
+      0.8f,  // ALGO_HIHAT
+      0.5f,  // ALGO_KARPLUS - reduce gain
+      0.3f,  // ALGO_MODAL - reduce gain significantly
+      0.3f,  // ALGO_ZAP - reduce gain significantly
+      0.7f,  // ALGO_CLAP
+      0.8f,  // ALGO_COWBELL
+    };
+    return gains[algorithm];
+  }
+
+  // Free voice if there is one, otherwise steal the quietest (oldest on a tie)
+  int allocateVoice() {
+    int steal = 0;
+    for (int v = 0; v < MaxVoices; v++) {
+      if (!voices.active[v]) {
+        return v;
+      }
+      if (voices.envAmplitude[v] < voices.envAmplitude[steal] ||
+          (voices.envAmplitude[v] == voices.envAmplitude[steal] &&
+           (int32_t)(voices.startSample[v] - voices.startSample[steal]) < 0)) {
+        steal = v;
+      }
+    }
+    return steal;
+  }
+
+  // Seconds since voice `v` was triggered
+  float getVoiceElapsed(int v) const {
+    if (triggerClock == CLOCK_SYSTEM) {
+      return (float)(clockMs - voices.startTime[v]) / 1000.0f;
+    }
+    return (float)(sampleCount - voices.startSample[v]) * samplePeriod;
+  }
+
+  void initializeEnvelopes(int v) {
+    const uint8_t algorithm = voices.algorithm[v];
+    const float period = algorithmPeriod(algorithm);
+    float& envDecayRate = voices.envDecayRate[v];
+
+    voices.envAmplitude[v] = 1.0f;
+    voices.envFrequency[v] = voices.currentFrequency[v];
+
+    // Set decay rates based on algorithm
+    switch (algorithm) {
+      case ALGO_BASS:
+        // CV2 controls sustain/decay balance
+        envDecayRate = 1.5f + algorithmParam * 3.5f;  // 1.5-5 Hz decay (longer for bass)
+        break;
+      case ALGO_ZAP:
+        // CV2 controls decay speed (faster = more aggressive)
+        envDecayRate = 8.0f + algorithmParam * 12.0f;  // 8-20 Hz decay
+        break;
+      case ALGO_SNARE:
+        // CV2 controls decay time (0.5x to 3.0x speed)
+        envDecayRate = 8.0f * (0.5f + algorithmParam * 2.5f);  // 4-28 Hz decay
+        voices.snareNoiseAmp[v] = 1.0f;
+        voices.snareToneAmp[v] = 1.0f;
+        break;
+      case ALGO_HIHAT:
+        // CV2 controls decay time (0.5x to 4.0x speed)
+        envDecayRate = 20.0f * (0.5f + algorithmParam * 3.5f);  // 10-90 Hz decay
+        voices.hihatEnvelope[v] = 1.0f;
+        break;
+      case ALGO_KARPLUS:
+        envDecayRate = 3.0f + algorithmParam * 5.0f;  // 3-8 Hz decay
+        voices.karplusDamping[v] = 0.995f - algorithmParam * 0.2f;  // 0.995-0.795 damping
+        initializeKarplusStrong(v);
+        break;
+      case ALGO_MODAL:
+        envDecayRate = 4.0f + algorithmParam * 6.0f;  // 4-10 Hz decay
+        setupModalModes(v);
+        break;
+      case ALGO_CLAP:
+        // CV2 controls decay time (0.5x to 3.0x speed)
+        envDecayRate = 12.0f * (0.5f + algorithmParam * 2.5f);  // 6-42 Hz decay
+        voices.clapPulseEnv[v] = 1.0f;
+        voices.clapReverbEnv[v] = 1.0f;
+        break;
+      case ALGO_COWBELL:
+        // CV2 controls metallic resonance (affects filtering)
+        envDecayRate = 4.0f + algorithmParam * 6.0f;  // 4-10 Hz decay
+        // Reset cowbell oscillator phases
+        for (int i = 0; i < 4; i++) {
+          voices.cowbell[v].re[i] = 1.0f;
+          voices.cowbell[v].im[i] = 0.0f;
+        }
+        break;
+      default:
+        envDecayRate = 5.0f + algorithmParam * 5.0f;  // 5-10 Hz decay
+        break;
+    }
+
+    // Recursive envelope coefficients - the only exp() calls per hit
+    voices.ampEnv[v].trigger(envDecayRate, period);
+    voices.pitchEnvelope[v].trigger((algorithm == ALGO_ZAP) ? 15.0f : 5.0f, period);
+    voices.snareNoiseEnv[v].trigger(envDecayRate * 1.5f, period);  // Noise decays faster than tone
+    voices.snarePitchEnv[v].trigger(25.0f, period);
+    voices.bassCutoffEnv[v].trigger(8.0f, period);
+    voices.zapSweepEnv[v].trigger(20.0f, period);
+    voices.clapReverbEnvelope[v].trigger(envDecayRate * (0.5f + algorithmParam * 1.5f), period);  // CV2: 0.5x-2.0x
+    voices.clapPulses[v].trigger(4, 0.03f, 0.01f, 50.0f, period);  // 4 pulses, 30ms apart, 10ms wide
+  }
+
+  void renderVoiceMix(float* out, int frames) {
+    for (int frame = 0; frame < frames; frame++) {
+      out[frame] = 0.0f;
+    }
+
+    // Control-rate work: parameters can only change between blocks
+    updateRealtimeFrequency();
+
+    // Group active voices by algorithm; trigger time at the first frame
+    int voiceList[NUM_ALGORITHMS][MaxVoices];
+    int voiceCount[NUM_ALGORITHMS] = {};
+    float startTimes[MaxVoices];
+    for (int v = 0; v < MaxVoices; v++) {
+      if (voices.active[v]) {
+        uint8_t algorithm = voices.algorithm[v];
+        voiceList[algorithm][voiceCount[algorithm]++] = v;
+        startTimes[v] = getVoiceElapsed(v);
+      }
+    }
+
+    // Oversampled algorithms sum into their own mix at the higher rate.
+    // The decimator keeps running on silence until its filters have
+    // emptied, then costs nothing until the next oversampled hit.
+    constexpr int factor = Oversampling::factor;
+    float oversampled[BlockSize * factor];
+    bool decimate = false;
+    if constexpr (factor > 1) {
+      bool ringing = false;
+      for (int algorithm = 0; algorithm < NUM_ALGORITHMS; algorithm++) {
+        ringing |= voiceCount[algorithm] > 0 && oversampleFactor(algorithm) > 1;
+      }
+      decimate = ringing || decimatorTail > 0;
+      if (ringing) {
+        decimatorTail = Decimator<float, factor>::flushFrames;
+      } else if (decimatorTail > 0) {
+        decimatorTail -= frames;
+      }
+
+      if (decimate) {
+        for (int i = 0; i < frames * factor; i++) {
+          oversampled[i] = 0.0f;
+        }
+      }
+    }
+
+    // Each algorithm renders all of its voices in one pass, summed into out
+    renderAlgorithm<ALGO_BASS>(voiceList[ALGO_BASS], voiceCount[ALGO_BASS], startTimes, out, oversampled, frames);
+    renderAlgorithm<ALGO_SNARE>(voiceList[ALGO_SNARE], voiceCount[ALGO_SNARE], startTimes, out, oversampled, frames);
+    renderAlgorithm<ALGO_HIHAT>(voiceList[ALGO_HIHAT], voiceCount[ALGO_HIHAT], startTimes, out, oversampled, frames);
+    renderAlgorithm<ALGO_KARPLUS>(voiceList[ALGO_KARPLUS], voiceCount[ALGO_KARPLUS], startTimes, out, oversampled, frames);
+    renderAlgorithm<ALGO_MODAL>(voiceList[ALGO_MODAL], voiceCount[ALGO_MODAL], startTimes, out, oversampled, frames);
+    renderAlgorithm<ALGO_ZAP>(voiceList[ALGO_ZAP], voiceCount[ALGO_ZAP], startTimes, out, oversampled, frames);
+    renderAlgorithm<ALGO_CLAP>(voiceList[ALGO_CLAP], voiceCount[ALGO_CLAP], startTimes, out, oversampled, frames);
+    renderAlgorithm<ALGO_COWBELL>(voiceList[ALGO_COWBELL], voiceCount[ALGO_COWBELL], startTimes, out, oversampled, frames);
+
+    if (decimate) {
+      for (int frame = 0; frame < frames; frame++) {
+        out[frame] += decimator.process(&oversampled[frame * factor]);
+      }
+    }
+
+    sampleCount += frames;
+  }
+
+  // One algorithm's voices into `out`, or at its oversampled rate into
+  // `oversampled`
+  template <uint8_t Algorithm>
+  void renderAlgorithm(const int* voiceList, int voiceCount, const float* startTimes, float* out,
+                       float* oversampled, int frames) {
+    if (voiceCount == 0) {
+      return;
+    }
+    if constexpr (oversampleFactor(Algorithm) > 1) {
+      renderVoices<Algorithm>(voiceList, voiceCount, startTimes, oversampled, frames * oversampleFactor(Algorithm));
+    } else {
+      (void)oversampled;
+      renderVoices<Algorithm>(voiceList, voiceCount, startTimes, out, frames);
+    }
+  }
+
+  // `frames` at the algorithm's own rate
+  template <uint8_t Algorithm>
+  void renderVoices(const int* voiceList, int voiceCount, const float* startTimes, float* out, int frames) {
+    constexpr float period = algorithmPeriod(Algorithm);
+    const float gain = MASTER_GAIN * algorithmGain(Algorithm);
+    probe.algorithmStarted(Algorithm);
+
+    int list[MaxVoices];
+    for (int n = 0; n < voiceCount; n++) {
+      list[n] = voiceList[n];
+    }
+
+    for (int frame = 0; frame < frames && voiceCount > 0; frame++) {
+      float sum = 0.0f;
+
+      for (int n = 0; n < voiceCount; ) {
+        int v = list[n];
+        float timeElapsed = startTimes[v] + (float)frame * period;
+        sum += generateAlgorithmSample<Algorithm>(v, timeElapsed);
+
+        // Envelope has decayed enough to stop - free the voice
+        if (voices.envAmplitude[v] < 0.001f) {
+          voices.active[v] = false;
+          list[n] = list[--voiceCount];
+        } else {
+          n++;
+        }
+      }
+
+      out[frame] += sum * gain;
+    }
+
+    probe.algorithmFinished(Algorithm, frames / oversampleFactor(Algorithm));
+  }
+
+  template <uint8_t Algorithm>
+  float generateAlgorithmSample(int v, float timeElapsed) {
+    updateAlgorithmEnvelopes<Algorithm>(v);
+
+    if constexpr (Algorithm == ALGO_BASS) {
+      return generateBassDrum(v, timeElapsed);
+    } else if constexpr (Algorithm == ALGO_ZAP) {
+      return generateZapSound(v, timeElapsed);
+    } else if constexpr (Algorithm == ALGO_SNARE) {
+      return generateSnareDrum(v, timeElapsed);
+    } else if constexpr (Algorithm == ALGO_HIHAT) {
+      return generateHiHat(v, timeElapsed);
+    } else if constexpr (Algorithm == ALGO_KARPLUS) {
+      return generateKarplusStrong(v);
+    } else if constexpr (Algorithm == ALGO_MODAL) {
+      return generateModalSynthesis(v);
+    } else if constexpr (Algorithm == ALGO_CLAP) {
+      return generateClap(v);
+    } else {
+      return generateCowbell(v);
+    }
+  }
+
+  // Output stage shared by all algorithms (voices arrive with master gain
+  // and the algorithm gain applied): lowpass, then soft clip
+  float applyOutputStage(float sample) {
+    // Apply anti-aliasing lowpass filter
+    sample = LOWPASS_ALPHA * sample + (1.0f - LOWPASS_ALPHA) * lastSample;
+    lastSample = sample;
+
+    // Soft saturation instead of hard clipping
+    if (sample > 0.8f) {
+      sample = 0.8f + 0.2f * tanhf((sample - 0.8f) * 5.0f);
+    } else if (sample < -0.8f) {
+      sample = -0.8f + 0.2f * tanhf((sample + 0.8f) * 5.0f);
+    }
+
+    return sample;
+  }
+
+  template <uint8_t Algorithm>
+  void updateAlgorithmEnvelopes(int v) {
+    // Exponential decay for amplitude
+    voices.envAmplitude[v] = voices.ampEnv[v].process();
+
+    // Pitch envelope handling - BASS and ZAP have pitch envelopes
+    if constexpr (Algorithm == ALGO_BASS || Algorithm == ALGO_ZAP) {
+      // Use real-time current frequency as base for pitch envelope
+      voices.envFrequency[v] = voices.currentFrequency[v] * (1.0f + 2.0f * voices.pitchEnvelope[v].process());
+    } else {
+      voices.envFrequency[v] = voices.currentFrequency[v];
+    }
+
+    // Snare-specific envelope updates (tone follows the amplitude envelope)
+    if constexpr (Algorithm == ALGO_SNARE) {
+      voices.snareNoiseAmp[v] = voices.snareNoiseEnv[v].process();
+      voices.snareToneAmp[v] = voices.envAmplitude[v];
+    }
+
+    // Hi-hat envelope (very fast decay)
+    if constexpr (Algorithm == ALGO_HIHAT) {
+      voices.hihatEnvelope[v] = voices.envAmplitude[v];
+    }
+
+    // Clap envelope (pulse + reverb) - CV2 controls decay time
+    if constexpr (Algorithm == ALGO_CLAP) {
+      voices.clapPulseEnv[v] = voices.clapPulses[v].process();
+      voices.clapReverbEnv[v] = voices.clapReverbEnvelope[v].process();
+    }
+  }
+
+  // Pitch CV stays live for every ringing voice, scaled for its own algorithm
+  void updateRealtimeFrequency() {
+    currentFrequency = scaleFrequency(frequency, currentAlgorithm);
+
+    for (int v = 0; v < MaxVoices; v++) {
+      if (!voices.active[v]) {
+        continue;
+      }
+
+      const uint8_t algorithm = voices.algorithm[v];
+      const float voiceFrequency = scaleFrequency(frequency, algorithm);
+      voices.currentFrequency[v] = voiceFrequency;
+
+      // For most algorithms, update envelope frequency immediately
+      // Exception: BASS and ZAP use pitch envelopes that modify this base frequency
+      if (algorithm != ALGO_BASS && algorithm != ALGO_ZAP) {
+        voices.envFrequency[v] = voiceFrequency;
+      }
+
+      // Update modal frequencies in real-time, retuning the rotators only
+      // once the pitch has moved
+      if (algorithm == ALGO_MODAL && coefficientsStale(voiceFrequency, voices.modalFrequency[v])) {
+        tuneModalModes(v, voiceFrequency);
+      }
+
+      // For Karplus-Strong, retune the loop length; the string keeps ringing
+      if (algorithm == ALGO_KARPLUS) {
+        setKarplusDelay(v, voiceFrequency);
+      }
+    }
+  }
+
+  // Improved linear congruential generator for white noise
+  float generateWhiteNoise(int v) {
+    uint32_t& noiseState = voices.noiseState[v];
+    noiseState = noiseState * 1103515245 + 12345;
+    return (float)((noiseState >> 16) & 0x7FFF) / 32768.0f - 1.0f;
+  }
+
+  float generateBassDrum(int v, float timeElapsed) {
+    // Authentic 808-style bass drum: self-oscillating resonant filter approach
+    // The 808 kick uses a filter set close to self-oscillation, excited by an impulse
+    const float envFrequency = voices.envFrequency[v];
+    float& bassImpulse = voices.bassImpulse[v];
+
+    // Generate impulse at the start (first few samples)
+    if (timeElapsed < 0.002f) {  // 2ms impulse
+      bassImpulse = 1.0f - (timeElapsed / 0.002f);
+    } else {
+      bassImpulse = 0.0f;
+    }
+
+    // Filter cutoff envelope: starts high, drops to bass frequency
+    float cutoffEnv = voices.bassCutoffEnv[v].process();
+    float bassFilterCutoff = envFrequency + (envFrequency * 3.0f * cutoffEnv);  // 1x to 4x frequency range
+
+    // High resonance for self-oscillation (Q factor)
+    float resonance = 8.0f + algorithmParam * 12.0f;  // Q: 8-20
+
+    // Process impulse through resonant filter
+    updateResonantFilter(voices.bassFilter[v], bassFilterCutoff, resonance, algorithmPeriod(ALGO_BASS));
+    float output = processFilter(voices.bassFilter[v], bassImpulse);
+
+    // Apply amplitude envelope
+    output *= voices.envAmplitude[v];
+
+    return output * 0.8f;  // Scale for headroom
+  }
+
+  float generateZapSound(int v, float timeElapsed) {
+    // Classic ZAP sound: dramatic pitch sweep from high to low + noise burst
+    const float envAmplitude = voices.envAmplitude[v];
+
+    // Dramatic pitch envelope: starts very high, drops rapidly
+    float pitchEnv = voices.zapSweepEnv[v].process();
+    float startMultiplier = 8.0f + algorithmParam * 12.0f;  // 8x to 20x starting frequency
+    float zapFreq = voices.currentFrequency[v] * (1.0f + startMultiplier * pitchEnv);
+
+    // Main ZAP oscillator (sawtooth for more aggressive sound)
+    float phase = fmodf(zapFreq * timeElapsed, 1.0f);
+    float sawtooth = 2.0f * phase - 1.0f;  // -1 to +1 sawtooth
+
+    float sample = sawtooth * envAmplitude * 0.5f;
+
+    // Add noise burst at the beginning for extra punch
+    if (timeElapsed < 0.05f) {  // 50ms noise burst
+      float noiseBurst = generateWhiteNoise(v) * (1.0f - timeElapsed / 0.05f) * 0.3f;
+      sample += noiseBurst;
+    }
+
+    // Add harmonics based on parameter (more aggressive with higher CV2)
+    if (algorithmParam > 0.1f) {
+      float harmonicLevel = algorithmParam * 0.4f;
+      float harmonic = sinf(TWO_PI_F * zapFreq * 2.0f * timeElapsed) * envAmplitude * harmonicLevel;
+      sample += harmonic;
+    }
+
+    return sample * 0.7f;  // Scale for headroom
+  }
+
+  float generateSnareDrum(int v, float timeElapsed) {
+    // Classic 909/808-style snare: tone with pitch envelope + filtered noise
+
+    // Tone component with pitch envelope (starts high, drops quickly)
+    float pitchEnv = voices.snarePitchEnv[v].process();
+    float toneFreq = voices.envFrequency[v] * (1.0f + 2.0f * pitchEnv);  // 1x to 3x frequency
+
+    // Main tone oscillator
+    float tone = sinf(TWO_PI_F * toneFreq * timeElapsed) * voices.snareToneAmp[v];
+
+    // Noise component (for snare rattle)
+    float noise = generateWhiteNoise(v) * voices.snareNoiseAmp[v];
+
+    // Bandpass filter the noise (classic snare frequency range)
+    setBandpassFilter(voices.bpf[v], 800.0f + algorithmParam * 1200.0f, 2.0f, algorithmPeriod(ALGO_SNARE));  // 800-2000Hz
+    float filteredNoise = processFilter(voices.bpf[v], noise);
+
+    // Mix tone and noise: 60% tone, 40% noise
+    return (tone * 0.6f + filteredNoise * 0.4f) * 0.7f;
+  }
+
+  float generateHiHat(int v, float timeElapsed) {
+    // 808-style hi-hat: multiple square waves + noise through bandpass filter
+    const float envFrequency = voices.envFrequency[v];
+
+    float square1 = (sinf(TWO_PI_F * envFrequency * 2.1f * timeElapsed) > 0.0f) ? 1.0f : -1.0f;
+    float square2 = (sinf(TWO_PI_F * envFrequency * 3.3f * timeElapsed) > 0.0f) ? 1.0f : -1.0f;
+    float square3 = (sinf(TWO_PI_F * envFrequency * 4.7f * timeElapsed) > 0.0f) ? 1.0f : -1.0f;
+    float square4 = (sinf(TWO_PI_F * envFrequency * 6.1f * timeElapsed) > 0.0f) ? 1.0f : -1.0f;
+
+    float squareSum = (square1 + square2 * 0.8f + square3 * 0.6f + square4 * 0.4f) * 0.25f;
+
+    // Add noise component
+    float noise = generateWhiteNoise(v) * 0.8f;
+
+    // Fixed bandpass filter (classic hi-hat frequency): 10kHz, Q=3
+    setBandpassFilter(voices.bpf[v], 10000.0f, 3.0f, algorithmPeriod(ALGO_HIHAT));
+    float filtered = processFilter(voices.bpf[v], squareSum + noise);
+
+    return filtered * voices.hihatEnvelope[v] * 1.5f;
+  }
+
+  float generateKarplusStrong(int v) {
+    // Karplus-Strong algorithm: delay line with feedback and damping
+    float* karplusBuffer = voices.karplusBuffer[v];
+    int& karplusWrite = voices.karplusWrite[v];
+
+    float output;
+    if (voices.karplusBurst[v] > 0) {
+      // First period after a hit: the noise burst replaces what the line held
+      voices.karplusBurst[v]--;
+      output = generateWhiteNoise(v) * 0.5f;
+    } else {
+      float delayed = karplusBuffer[(karplusWrite - voices.karplusDelay[v]) & (KARPLUS_BUFFER_SIZE - 1)];
+
+      // Low-pass filter (average of this and the previous sample, half a
+      // sample of delay), then the all-pass for the fractional delay
+      float averaged = (delayed + voices.karplusLast[v]) * 0.5f;
+      voices.karplusLast[v] = delayed;
+
+      const float c = voices.karplusAllpass[v];
+      float tuned = c * averaged + voices.karplusAllpassX[v] - c * voices.karplusAllpassY[v];
+      voices.karplusAllpassX[v] = averaged;
+      voices.karplusAllpassY[v] = tuned;
+
+      output = tuned * voices.karplusDamping[v];
+    }
+
+    karplusBuffer[karplusWrite] = output;
+    karplusWrite = (karplusWrite + 1) & (KARPLUS_BUFFER_SIZE - 1);
+
+    return output * voices.envAmplitude[v];
+  }
+
+  float generateModalSynthesis(int v) {
+    // Modal synthesis: sum of multiple decaying sine waves
+    float output = voices.modes[v].processSine();
+
+    // Normalize and apply envelope - reduced amplitude to prevent clipping
+    return output * voices.envAmplitude[v] * modalGain;
+  }
+
+  float generateClap(int v) {
+    // 808-style clap: bandpass filtered noise with multi-pulse envelope
+    float noise = generateWhiteNoise(v) * 1.2f;
+
+    // Fixed bandpass filter (centered around 1kHz) - no pitch dependency needed
+    setBandpassFilter(voices.bpf[v], 1000.0f, 3.0f, algorithmPeriod(ALGO_CLAP));
+    float filteredNoise = processFilter(voices.bpf[v], noise);
+
+    // Apply pulse envelope + reverb envelope (reverb decay controlled by CV2)
+    float pulseComponent = filteredNoise * voices.clapPulseEnv[v];
+    float reverbComponent = filteredNoise * voices.clapReverbEnv[v] * 0.3f;
+
+    return (pulseComponent + reverbComponent) * 1.8f;
+  }
+
+  float generateCowbell(int v) {
+    // Authentic 808 cowbell: 4 pulse oscillators at fixed frequencies,
+    // weighted so higher frequencies have less amplitude
+    float output = voices.cowbell[v].processPulse(cowbellWeights);
+
+    // Normalize and apply envelope
+    output = output * 0.25f * voices.envAmplitude[v];
+
+    // CV2 controls metallic filtering
+    float filterFreq = 2000.0f + algorithmParam * 3000.0f;  // 2-5kHz
+    setBandpassFilter(voices.bpf[v], filterFreq, 4.0f, algorithmPeriod(ALGO_COWBELL));  // High Q for metallic sound
+    output = processFilter(voices.bpf[v], output);
+
+    return output * 0.8f;
+  }
+
+  // True if `value` has moved far enough from `cached` to need new coefficients
+  static bool coefficientsStale(float value, float cached) {
+    return fabsf(value - cached) > COEFF_TOLERANCE * cached;
+  }
+
+  static void initializeFilter(DrumFilter& filter) {
+    filter.x1 = filter.x2 = filter.y1 = filter.y2 = 0.0f;
+    filter.q31.reset();
+    filter.dirty = true;
+  }
+
+  static void setCoefficients(DrumFilter& filter, float a0, float a1, float a2, float b1, float b2) {
+    filter.a0 = a0;
+    filter.a1 = a1;
+    filter.a2 = a2;
+    filter.b1 = b1;
+    filter.b2 = b2;
+    if constexpr (FixedPointDsp) {
+      filter.q31.setCoefficients(a0, a1, a2, b1, b2);
+    }
+  }
+
+  // `period`: the sample period the calling algorithm renders at
+  static void setBandpassFilter(DrumFilter& filter, float centerFreq, float Q, float period) {
+    // Generators call this every sample; skip the sin/cos unless inputs moved
+    if (!filter.dirty && Q == filter.Q && period == filter.period && !coefficientsStale(centerFreq, filter.frequency)) {
+      return;
+    }
+    filter.frequency = centerFreq;
+    filter.Q = Q;
+    filter.period = period;
+    filter.dirty = false;
+
+    float w = TWO_PI_F * centerFreq * period;
+    float alpha = sinf(w) / (2.0f * Q);
+    float norm = 1.0f / (1.0f + alpha);
+
+    setCoefficients(filter, alpha * norm, 0.0f, -alpha * norm, -2.0f * cosf(w) * norm, (1.0f - alpha) * norm);
+  }
+
+  static void updateResonantFilter(DrumFilter& filter, float cutoff, float resonance, float period) {
+    // Prevent filter instability
+    cutoff = clampf(cutoff, 20.0f, 8000.0f);
+    resonance = clampf(resonance, 0.5f, 20.0f);
+
+    // Bass cutoff sweeps every sample; recompute only past the tolerance
+    if (!filter.dirty && resonance == filter.Q && period == filter.period && !coefficientsStale(cutoff, filter.frequency)) {
+      return;
+    }
+    filter.frequency = cutoff;
+    filter.Q = resonance;
+    filter.period = period;
+    filter.dirty = false;
+
+    // Calculate filter coefficients for 2-pole resonant lowpass
+    float w = TWO_PI_F * cutoff * period;
+    float cosw = cosf(w);
+    float alpha = sinf(w) / (2.0f * resonance);
+    float norm = 1.0f / (1.0f + alpha);
+
+    setCoefficients(filter, (1.0f - cosw) * 0.5f * norm, (1.0f - cosw) * norm, (1.0f - cosw) * 0.5f * norm,
+                    -2.0f * cosw * norm, (1.0f - alpha) * norm);
+  }
+
+  static float processFilter(DrumFilter& filter, float input) {
+    if constexpr (FixedPointDsp) {
+      return filter.q31.processFloat(input);
+    } else {
+      float output = filter.a0 * input + filter.a1 * filter.x1 + filter.a2 * filter.x2
+                     - filter.b1 * filter.y1 - filter.b2 * filter.y2;
+
+      // Update delay lines
+      filter.x2 = filter.x1;
+      filter.x1 = input;
+      filter.y2 = filter.y1;
+      filter.y1 = output;
+
+      return output;
+    }
+  }
+
+  // A new hit: the noise burst is written one sample at a time over the
+  // first period, so triggering costs nothing per buffer sample
+  void initializeKarplusStrong(int v) {
+    setKarplusDelay(v, voices.currentFrequency[v]);
+    voices.karplusBurst[v] = voices.karplusDelay[v];
+    voices.karplusLast[v] = 0.0f;
+    voices.karplusAllpassX[v] = 0.0f;
+    voices.karplusAllpassY[v] = 0.0f;
+  }
+
+  // Loop length for `frequency`: whole samples in the line, the averaging
+  // lowpass's half sample, and a first-order all-pass for the remaining
+  // 0.5-1.5 samples, where its phase delay stays flat up through the
+  // harmonics that ring longest
+  void setKarplusDelay(int v, float frequency) {
+    float loop = (float)SampleRate / clampf(frequency, KARPLUS_MIN_FREQUENCY, 0.25f * SampleRate) - 0.5f;
+    int delay = (int)(loop - 0.5f);
+    float fraction = loop - (float)delay;
+
+    voices.karplusDelay[v] = delay;
+    voices.karplusAllpass[v] = (1.0f - fraction) / (1.0f + fraction);
+  }
+
+  void setupModalModes(int v) {
+    // Configure modes based on base frequency and algorithm parameter
+    const float period = algorithmPeriod(ALGO_MODAL);
+    float baseDecay = 2.0f + algorithmParam * 8.0f;  // 2-10 Hz base decay
+
+    for (int i = 0; i < ModalModes; i++) {
+      voices.modes[v].start(i, modalAmplitudes[i], expf(-baseDecay * modalDecayRatios[i] * period));
+    }
+    tuneModalModes(v, voices.currentFrequency[v]);
+  }
+
+  void tuneModalModes(int v, float baseFreq) {
+    const float period = algorithmPeriod(ALGO_MODAL);
+    for (int i = 0; i < ModalModes; i++) {
+      voices.modes[v].tune(i, baseFreq * modalRatios[i] * period);
+    }
+    voices.modalFrequency[v] = baseFreq;
+  }
+
+  void setupCowbell(int v) {
+    for (int i = 0; i < 4; i++) {
+      voices.cowbell[v].start(i, 1.0f, 1.0f);
+      voices.cowbell[v].tune(i, cowbellFrequencies[i] * cowbellPeriod);
+    }
+  }
+};
+
+#endif // BIRDSBOARD_TOCKUS_ENGINE_H